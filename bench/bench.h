@@ -0,0 +1,248 @@
+//
+// Created by gvisan on 18.10.2026.
+//
+
+#ifndef DSL_BENCH_H
+#define DSL_BENCH_H
+
+#include<algorithm> //for sort, upper_bound
+#include<chrono> //for steady_clock
+#include<cmath> //for pow
+#include<cstddef> //for size_t
+#include<cstdint> //for uint64_t
+#include<cstdio> //for snprintf
+#include<functional> //for function
+#include<string>
+#include<type_traits> //for is_same
+#include<vector>
+
+namespace dsl_bench {
+
+    /* The result of running a benchmark: the number of operations and the time they took */
+    struct measurement {
+        size_t operations;
+        double seconds;
+    };
+
+    /* A benchmark case, one line of the report */
+    struct benchmark {
+        std::string container;
+        std::string operation;
+        std::string key;
+        std::string distribution;
+        size_t size;
+        std::function<measurement()> run;
+    };
+
+    /* The settings given on the command line */
+    struct options {
+        /* The container sizes of the main matrix */
+        std::vector<size_t> sizes;
+
+        /* The minimum number of operations timed by a benchmark, small containers repeat their work to reach it */
+        size_t min_operations;
+    };
+
+    using registry = std::vector<benchmark>;
+
+    /* Add the benchmarks of the dsl containers against their std counterparts */
+    void register_containers(registry &benchmarks, const options &settings);
+
+    /* Add the benchmarks of the specialized sets and set operations */
+    void register_sets(registry &benchmarks, const options &settings);
+
+    /* Add the benchmarks of the parallel traversal of the containers */
+    void register_parallel(registry &benchmarks, const options &settings);
+
+    /* Runs the function and returns the time it took, in seconds */
+    template<class function>
+    double time(function &&work) {
+        auto start = std::chrono::steady_clock::now();
+        work();
+        auto stop = std::chrono::steady_clock::now();
+        return std::chrono::duration<double>(stop - start).count();
+    }
+
+    /* Keeps the compiler from optimizing away the computation of the value */
+    template<class type>
+    void keep(const type &value) {
+#if defined(__GNUC__)
+        asm volatile("" : : "r"(&value) : "memory");
+#else
+        static volatile const void *sink;
+        sink = &value;
+#endif
+    }
+
+    /* The splitmix64 finalizer, used to spread the key ids */
+    inline uint64_t mix(uint64_t z) {
+        z += 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30u)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27u)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31u);
+    }
+
+    /* A small xorshift64* generator, so the benchmarks do not depend on the speed of the standard engines */
+    struct xorshift {
+        uint64_t state;
+
+        explicit xorshift(uint64_t seed) : state(mix(seed) | 1u) {
+
+        }
+
+        uint64_t next() {
+            state ^= state >> 12u;
+            state ^= state << 25u;
+            state ^= state >> 27u;
+            return state * 0x2545F4914F6CDD1DULL;
+        }
+
+        /* Returns a number in [0, bound) */
+        size_t below(size_t bound) {
+            return static_cast<size_t>(next() % bound);
+        }
+    };
+
+    /* The key with the given id, for each key type. Different ids give different keys */
+    template<class key>
+    key make_key(uint64_t id);
+
+    template<>
+    inline int make_key<int>(uint64_t id) {
+        return static_cast<int>(id);
+    }
+
+    template<>
+    inline uint64_t make_key<uint64_t>(uint64_t id) {
+        return id;
+    }
+
+    /* The strings are longer than the small string buffer, so every key owns memory */
+    template<>
+    inline std::string make_key<std::string>(uint64_t id) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "key-%016llx", static_cast<unsigned long long>(id));
+        return buffer;
+    }
+
+    template<class key>
+    const char *key_name();
+
+    template<>
+    inline const char *key_name<int>() { return "int32"; }
+
+    template<>
+    inline const char *key_name<uint64_t>() { return "uint64"; }
+
+    template<>
+    inline const char *key_name<std::string>() { return "string"; }
+
+    /* The order in which the keys are inserted, searched and erased */
+    enum class distribution {
+        uniform, zipf, sorted
+    };
+
+    inline const char *distribution_name(distribution order) {
+        switch (order) {
+            case distribution::uniform:
+                return "uniform";
+            case distribution::zipf:
+                return "zipf";
+            default:
+                return "sorted";
+        }
+    }
+
+    /* Returns n distinct keys, in random order. Both id functions are bijections, so the keys are all distinct.
+     * The int ids are multiplied by an odd constant modulo 2^31, so that they stay positive */
+    template<class key>
+    std::vector<key> make_keys(size_t n, uint64_t seed) {
+        std::vector<key> keys;
+        keys.reserve(n);
+        uint64_t salt = mix(seed);
+        for (uint64_t i = 0; i < n; i++) {
+            uint64_t id = std::is_same<key, int>::value ? ((i + salt) * 0x9E3779B1ULL) & 0x7FFFFFFFu : mix(i ^ salt);
+            keys.push_back(make_key<key>(id));
+        }
+        return keys;
+    }
+
+    /* Returns the indices of the keys visited by count operations on n keys, in the given distribution.
+     * The zipf distribution has exponent 0.99: a few keys are visited most of the time */
+    inline std::vector<size_t> make_order(distribution order, size_t n, size_t count, uint64_t seed) {
+        std::vector<size_t> indices(count);
+        xorshift generator(seed);
+        switch (order) {
+            case distribution::uniform:
+                for (size_t &index : indices)
+                    index = generator.below(n);
+                break;
+            case distribution::zipf: {
+                std::vector<double> cumulative(n);
+                double total = 0;
+                for (size_t i = 0; i < n; i++)
+                    cumulative[i] = total += 1.0 / std::pow(static_cast<double>(i + 1), 0.99);
+                for (size_t &index : indices) {
+                    double target = static_cast<double>(generator.next() >> 11u) * 0x1.0p-53 * total;
+                    index = std::upper_bound(cumulative.begin(), cumulative.end(), target) - cumulative.begin();
+                    if (index >= n)
+                        index = n - 1;
+                }
+                break;
+            }
+            case distribution::sorted:
+                for (size_t i = 0; i < count; i++)
+                    indices[i] = i * n / count;
+                break;
+        }
+        return indices;
+    }
+
+    /* Returns a permutation of the n keys, in random order, or in ascending order for the sorted distribution.
+     * The zipf distribution visits the keys in random order, with repetitions */
+    template<class key>
+    std::vector<key> arrange(const std::vector<key> &keys, distribution order, uint64_t seed) {
+        std::vector<key> ans;
+        ans.reserve(keys.size());
+        if (order == distribution::zipf) {
+            for (size_t index : make_order(order, keys.size(), keys.size(), seed))
+                ans.push_back(keys[index]);
+            return ans;
+        }
+
+        ans = keys;
+        if (order == distribution::sorted) {
+            std::sort(ans.begin(), ans.end());
+        } else {
+            xorshift shuffle(seed);
+            for (size_t i = ans.size(); i > 1; i--)
+                std::swap(ans[i - 1], ans[shuffle.below(i)]);
+        }
+        return ans;
+    }
+
+    /* Returns count keys to search for, in the given distribution. The sorted distribution returns them in ascending order */
+    template<class key>
+    std::vector<key> make_probes(const std::vector<key> &keys, distribution order, size_t count, uint64_t seed) {
+        std::vector<key> sorted;
+        const std::vector<key> *source = &keys;
+        if (order == distribution::sorted) {
+            sorted = keys;
+            std::sort(sorted.begin(), sorted.end());
+            source = &sorted;
+        }
+
+        std::vector<key> probes;
+        probes.reserve(count);
+        for (size_t index : make_order(order, keys.size(), count, seed))
+            probes.push_back((*source)[index]);
+        return probes;
+    }
+
+    /* The number of times work over n elements is repeated to reach the minimum number of operations */
+    inline size_t repetitions(size_t n, const options &settings) {
+        return n >= settings.min_operations ? 1 : (settings.min_operations + n - 1) / n;
+    }
+}
+
+#endif //DSL_BENCH_H
@@ -0,0 +1,457 @@
+//
+// Created by gvisan on 18.10.2026.
+//
+
+#include<list>
+#include<queue> //for priority_queue
+#include<set>
+#include<string>
+#include<unordered_map>
+#include<dsl/btree_set.h>
+#include<dsl/compact_set.h>
+#include<dsl/flat_set.h>
+#include<dsl/hashmap.h>
+#include<dsl/heap.h>
+#include<dsl/list.h>
+#include<dsl/topk.h>
+#include<dsl/set.h>
+#include"bench.h"
+
+namespace dsl_bench {
+    namespace {
+
+        /* The value mapped by the keys of the hashmaps */
+        using mapped = uint64_t;
+
+        /* A number computed from every element visited by an iteration, so that the keys are really read */
+        inline size_t weight(int value) { return static_cast<size_t>(value); }
+
+        inline size_t weight(uint64_t value) { return static_cast<size_t>(value); }
+
+        inline size_t weight(const std::string &value) { return value.size() + static_cast<size_t>(value.back()); }
+
+        template<class first, class second>
+        size_t weight(const std::pair<first, second> &value) { return weight(value.first); }
+
+        /* How the benchmarks drive a container with find and erase by iterator: the sets and the hashmaps */
+        template<class container>
+        struct lookup_driver {
+            static container make(size_t) {
+                return container();
+            }
+
+            template<class key>
+            static void insert(container &structure, const key &value) {
+                structure.insert(value);
+            }
+
+            template<class key>
+            static bool find(container &structure, const key &value) {
+                return structure.find(value) != structure.end();
+            }
+
+            template<class key>
+            static void erase(container &structure, const key &value) {
+                auto position = structure.find(value);
+                if (position != structure.end())
+                    structure.erase(position);
+            }
+
+            static size_t iterate(container &structure) {
+                size_t ans = 0;
+                for (auto it = structure.begin(); it != structure.end(); ++it)
+                    ans += weight(*it);
+                return ans;
+            }
+        };
+
+        template<class container>
+        struct driver : lookup_driver<container> {
+
+        };
+
+        /* dsl::hashmap does not grow, so it gets one bucket per key */
+        template<class key>
+        struct driver<dsl::hashmap<key, mapped>> : lookup_driver<dsl::hashmap<key, mapped>> {
+            static dsl::hashmap<key, mapped> make(size_t n) {
+                return dsl::hashmap<key, mapped>(n > 0 ? n : 1);
+            }
+
+            static void insert(dsl::hashmap<key, mapped> &structure, const key &value) {
+                structure.insert({value, mapped()});
+            }
+        };
+
+        /* The std map reserves the same number of buckets */
+        template<class key>
+        struct driver<std::unordered_map<key, mapped>> : lookup_driver<std::unordered_map<key, mapped>> {
+            static std::unordered_map<key, mapped> make(size_t n) {
+                std::unordered_map<key, mapped> ans;
+                ans.reserve(n);
+                return ans;
+            }
+
+            static void insert(std::unordered_map<key, mapped> &structure, const key &value) {
+                structure.emplace(value, mapped());
+            }
+        };
+
+        /* Builds a container holding the keys */
+        template<class container, class key>
+        container build(const std::vector<key> &keys) {
+            container ans = driver<container>::make(keys.size());
+            for (const key &value : keys)
+                driver<container>::insert(ans, value);
+            return ans;
+        }
+
+        /* Makes copies of the container. They are built before timing, so that only the measured operation is timed */
+        template<class container>
+        std::vector<container> copies(const container &original, size_t count) {
+            std::vector<container> ans;
+            ans.reserve(count);
+            for (size_t i = 0; i < count; i++)
+                ans.push_back(original);
+            return ans;
+        }
+
+        /* Adds insert, find and erase in every distribution, and iterate, copy and clear, for a set or a map */
+        template<class container, class key>
+        void add_lookup(registry &benchmarks, const std::string &name, const options &settings, size_t max_size) {
+            using run = driver<container>;
+            const distribution orders[] = {distribution::uniform, distribution::zipf, distribution::sorted};
+
+            for (size_t n : settings.sizes) {
+                if (n > max_size)
+                    continue;
+                size_t reps = repetitions(n, settings);
+
+                for (distribution order : orders) {
+                    std::string order_name = distribution_name(order);
+
+                    benchmarks.push_back({name, "insert", key_name<key>(), order_name, n, [=]() {
+                        std::vector<key> keys = arrange(make_keys<key>(n, 1), order, 2);
+                        std::vector<container> built;
+                        built.reserve(reps);
+                        double seconds = time([&]() {
+                            for (size_t r = 0; r < reps; r++) {
+                                built.push_back(run::make(n));
+                                for (const key &value : keys)
+                                    run::insert(built.back(), value);
+                            }
+                        });
+                        return measurement{n * reps, seconds};
+                    }});
+
+                    benchmarks.push_back({name, "find", key_name<key>(), order_name, n, [=]() {
+                        std::vector<key> keys = make_keys<key>(n, 1);
+                        container structure = build<container>(keys);
+                        std::vector<key> probes = make_probes(keys, order, n * reps, 3);
+                        size_t found = 0;
+                        double seconds = time([&]() {
+                            for (const key &value : probes)
+                                found += run::find(structure, value);
+                        });
+                        keep(found);
+                        return measurement{probes.size(), seconds};
+                    }});
+
+                    benchmarks.push_back({name, "erase", key_name<key>(), order_name, n, [=]() {
+                        std::vector<key> keys = make_keys<key>(n, 1);
+                        std::vector<container> built = copies(build<container>(keys), reps);
+                        std::vector<key> victims = arrange(keys, order, 4);
+                        double seconds = time([&]() {
+                            for (container &structure : built)
+                                for (const key &value : victims)
+                                    run::erase(structure, value);
+                        });
+                        return measurement{n * reps, seconds};
+                    }});
+                }
+
+                benchmarks.push_back({name, "iterate", key_name<key>(), "none", n, [=]() {
+                    container structure = build<container>(make_keys<key>(n, 1));
+                    size_t sum = 0;
+                    double seconds = time([&]() {
+                        for (size_t r = 0; r < reps; r++)
+                            sum += run::iterate(structure);
+                    });
+                    keep(sum);
+                    return measurement{n * reps, seconds};
+                }});
+
+                benchmarks.push_back({name, "copy", key_name<key>(), "none", n, [=]() {
+                    container structure = build<container>(make_keys<key>(n, 1));
+                    std::vector<container> built;
+                    built.reserve(reps);
+                    double seconds = time([&]() {
+                        for (size_t r = 0; r < reps; r++)
+                            built.push_back(structure);
+                    });
+                    return measurement{n * reps, seconds};
+                }});
+
+                benchmarks.push_back({name, "clear", key_name<key>(), "none", n, [=]() {
+                    std::vector<container> built = copies(build<container>(make_keys<key>(n, 1)), reps);
+                    double seconds = time([&]() {
+                        for (container &structure : built)
+                            structure.clear();
+                    });
+                    return measurement{n * reps, seconds};
+                }});
+            }
+        }
+
+        /* How the benchmarks drive a heap */
+        template<class container>
+        struct heap_driver {
+            static void clear(container &structure) {
+                structure.clear();
+            }
+        };
+
+        template<class type>
+        struct heap_driver<std::priority_queue<type>> {
+            static void clear(std::priority_queue<type> &structure) {
+                structure = std::priority_queue<type>();
+            }
+        };
+
+        /* Adds push in every distribution, and pop, copy and clear, for a heap */
+        template<class container, class key>
+        void add_heap(registry &benchmarks, const std::string &name, const options &settings) {
+            const distribution orders[] = {distribution::uniform, distribution::zipf, distribution::sorted};
+
+            for (size_t n : settings.sizes) {
+                size_t reps = repetitions(n, settings);
+
+                for (distribution order : orders) {
+                    benchmarks.push_back({name, "insert", key_name<key>(), distribution_name(order), n, [=]() {
+                        std::vector<key> keys = arrange(make_keys<key>(n, 1), order, 2);
+                        std::vector<container> built(reps);
+                        double seconds = time([&]() {
+                            for (container &structure : built)
+                                for (const key &value : keys)
+                                    structure.push(value);
+                        });
+                        return measurement{n * reps, seconds};
+                    }});
+                }
+
+                benchmarks.push_back({name, "erase", key_name<key>(), "none", n, [=]() {
+                    std::vector<key> keys = make_keys<key>(n, 1);
+                    container original;
+                    for (const key &value : keys)
+                        original.push(value);
+                    std::vector<container> built = copies(original, reps);
+                    double seconds = time([&]() {
+                        for (container &structure : built)
+                            while (!structure.empty())
+                                structure.pop();
+                    });
+                    return measurement{n * reps, seconds};
+                }});
+
+                benchmarks.push_back({name, "copy", key_name<key>(), "none", n, [=]() {
+                    container original;
+                    for (const key &value : make_keys<key>(n, 1))
+                        original.push(value);
+                    std::vector<container> built;
+                    built.reserve(reps);
+                    double seconds = time([&]() {
+                        for (size_t r = 0; r < reps; r++)
+                            built.push_back(original);
+                    });
+                    return measurement{n * reps, seconds};
+                }});
+
+                benchmarks.push_back({name, "clear", key_name<key>(), "none", n, [=]() {
+                    container original;
+                    for (const key &value : make_keys<key>(n, 1))
+                        original.push(value);
+                    std::vector<container> built = copies(original, reps);
+                    double seconds = time([&]() {
+                        for (container &structure : built)
+                            heap_driver<container>::clear(structure);
+                    });
+                    return measurement{n * reps, seconds};
+                }});
+            }
+        }
+
+        /* Adds append, erase from the front, iterate, copy and clear, for a list. The lists are not reserved, so erase and
+         * clear free every node inside the timed region, as std::list does */
+        template<class container, class key>
+        void add_list(registry &benchmarks, const std::string &name, const options &settings) {
+            for (size_t n : settings.sizes) {
+                size_t reps = repetitions(n, settings);
+
+                auto make = [n]() {
+                    container ans;
+                    for (const key &value : make_keys<key>(n, 1))
+                        ans.insert(ans.end(), value);
+                    return ans;
+                };
+
+                benchmarks.push_back({name, "insert", key_name<key>(), "none", n, [=]() {
+                    std::vector<key> keys = make_keys<key>(n, 1);
+                    std::vector<container> built(reps);
+                    double seconds = time([&]() {
+                        for (container &structure : built)
+                            for (const key &value : keys)
+                                structure.insert(structure.end(), value);
+                    });
+                    return measurement{n * reps, seconds};
+                }});
+
+                benchmarks.push_back({name, "erase", key_name<key>(), "none", n, [=]() {
+                    std::vector<container> built = copies(make(), reps);
+                    double seconds = time([&]() {
+                        for (container &structure : built)
+                            while (!structure.empty())
+                                structure.erase(structure.begin());
+                    });
+                    return measurement{n * reps, seconds};
+                }});
+
+                benchmarks.push_back({name, "iterate", key_name<key>(), "none", n, [=]() {
+                    container structure = make();
+                    size_t sum = 0;
+                    double seconds = time([&]() {
+                        for (size_t r = 0; r < reps; r++)
+                            for (auto it = structure.begin(); it != structure.end(); ++it)
+                                sum += weight(*it);
+                    });
+                    keep(sum);
+                    return measurement{n * reps, seconds};
+                }});
+
+                benchmarks.push_back({name, "copy", key_name<key>(), "none", n, [=]() {
+                    container structure = make();
+                    std::vector<container> built;
+                    built.reserve(reps);
+                    double seconds = time([&]() {
+                        for (size_t r = 0; r < reps; r++)
+                            built.push_back(structure);
+                    });
+                    return measurement{n * reps, seconds};
+                }});
+
+                benchmarks.push_back({name, "clear", key_name<key>(), "none", n, [=]() {
+                    std::vector<container> built = copies(make(), reps);
+                    double seconds = time([&]() {
+                        for (container &structure : built)
+                            structure.clear();
+                    });
+                    return measurement{n * reps, seconds};
+                }});
+            }
+        }
+
+        /* flat_set inserts in O(n), so it is only measured on small sets */
+        constexpr size_t flat_max_size = 10000;
+
+        constexpr size_t unlimited = static_cast<size_t>(-1);
+
+        /* Keeping the best 100 of a stream of random scores: dsl::topk with one push per score and with one push per
+         * batch, against a heap whose top is compared with each score before replacing it */
+        void add_topk(registry &benchmarks, const options &settings) {
+            constexpr size_t best = 100;
+            const std::string operation = "stream_top_" + std::to_string(best);
+
+            for (size_t n : settings.sizes) {
+                size_t reps = repetitions(n, settings);
+
+                auto scores = [n]() {
+                    std::vector<float> ans(n);
+                    xorshift generator(1);
+                    for (float &score : ans)
+                        score = static_cast<float>(generator.next() >> 40u) * 0x1.0p-24f;
+                    return ans;
+                };
+
+                benchmarks.push_back({"dsl::topk", operation + "_batch", "float32", "uniform", n, [=]() {
+                    std::vector<float> stream = scores();
+                    float sum = 0;
+                    double seconds = time([&]() {
+                        for (size_t r = 0; r < reps; r++) {
+                            dsl::topk<float, std::less<float>, best> structure;
+                            structure.push(stream.begin(), stream.end());
+                            sum += structure.threshold();
+                        }
+                    });
+                    keep(sum);
+                    return measurement{n * reps, seconds};
+                }});
+
+                benchmarks.push_back({"dsl::topk", operation, "float32", "uniform", n, [=]() {
+                    std::vector<float> stream = scores();
+                    float sum = 0;
+                    double seconds = time([&]() {
+                        for (size_t r = 0; r < reps; r++) {
+                            dsl::topk<float, std::less<float>, best> structure;
+                            for (float score : stream)
+                                structure.push(score);
+                            sum += structure.threshold();
+                        }
+                    });
+                    keep(sum);
+                    return measurement{n * reps, seconds};
+                }});
+
+                auto guarded = [=](auto structure) {
+                    std::vector<float> stream = scores();
+                    float sum = 0;
+                    double seconds = time([&]() {
+                        for (size_t r = 0; r < reps; r++) {
+                            auto kept = structure;
+                            for (float score : stream) {
+                                if (kept.size() < best) {
+                                    kept.push(score);
+                                } else if (kept.top() < score) {
+                                    kept.pop();
+                                    kept.push(score);
+                                }
+                            }
+                            sum += kept.top();
+                        }
+                    });
+                    keep(sum);
+                    return measurement{n * reps, seconds};
+                };
+
+                benchmarks.push_back({"dsl::heap", operation, "float32", "uniform", n, [=]() {
+                    return guarded(dsl::heap<float, std::greater<float>>());
+                }});
+                benchmarks.push_back({"std::priority_queue", operation, "float32", "uniform", n, [=]() {
+                    return guarded(std::priority_queue<float, std::vector<float>, std::greater<float>>());
+                }});
+            }
+        }
+
+        template<class key>
+        void add_all(registry &benchmarks, const options &settings) {
+            add_lookup<std::set<key>, key>(benchmarks, "std::set", settings, unlimited);
+            add_lookup<dsl::set<key>, key>(benchmarks, "dsl::set", settings, unlimited);
+            add_lookup<dsl::compact_set<key>, key>(benchmarks, "dsl::compact_set", settings, unlimited);
+            add_lookup<dsl::btree_set<key>, key>(benchmarks, "dsl::btree_set", settings, unlimited);
+            add_lookup<dsl::flat_set<key>, key>(benchmarks, "dsl::flat_set", settings, flat_max_size);
+
+            add_lookup<std::unordered_map<key, mapped>, key>(benchmarks, "std::unordered_map", settings, unlimited);
+            add_lookup<dsl::hashmap<key, mapped>, key>(benchmarks, "dsl::hashmap", settings, unlimited);
+
+            add_heap<std::priority_queue<key>, key>(benchmarks, "std::priority_queue", settings);
+            add_heap<dsl::heap<key>, key>(benchmarks, "dsl::heap", settings);
+
+            add_list<std::list<key>, key>(benchmarks, "std::list", settings);
+            add_list<dsl::list<key>, key>(benchmarks, "dsl::list", settings);
+        }
+    }
+
+    void register_containers(registry &benchmarks, const options &settings) {
+        add_all<int>(benchmarks, settings);
+        add_all<uint64_t>(benchmarks, settings);
+        add_all<std::string>(benchmarks, settings);
+        add_topk(benchmarks, settings);
+    }
+}
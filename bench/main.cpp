@@ -0,0 +1,179 @@
+//
+// Created by gvisan on 18.10.2026.
+//
+
+#include<cstdio> //for printf
+#include<cstdlib> //for strtoull
+#include<cstring> //for strcmp
+#include<string>
+#include<thread> //for hardware_concurrency
+#include<sys/resource.h> //for getrusage, wait4
+#include<sys/wait.h> //for WIFEXITED
+#include<unistd.h> //for fork, pipe
+#include"bench.h"
+
+namespace {
+
+    using namespace dsl_bench;
+
+    /* A measurement and the peak resident set size of the process that ran it, in kilobytes */
+    struct report {
+        bool valid;
+        measurement result;
+        long peak_rss_kb;
+    };
+
+    /* Runs the benchmark in a child process, so that the peak resident set size belongs to this benchmark only */
+    report run_isolated(const benchmark &work) {
+        int channel[2];
+        if (pipe(channel) != 0)
+            return {false, {0, 0}, 0};
+
+        pid_t child = fork();
+        if (child < 0) {
+            close(channel[0]);
+            close(channel[1]);
+            return {false, {0, 0}, 0};
+        }
+
+        if (child == 0) {
+            close(channel[0]);
+            measurement result = work.run();
+            ssize_t written = write(channel[1], &result, sizeof(result));
+            _exit(written == sizeof(result) ? 0 : 1);
+        }
+
+        close(channel[1]);
+        measurement result{0, 0};
+        ssize_t received = read(channel[0], &result, sizeof(result));
+        close(channel[0]);
+
+        int status = 0;
+        struct rusage usage{};
+        wait4(child, &status, 0, &usage);
+        bool valid = received == sizeof(result) && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        return {valid, result, usage.ru_maxrss};
+    }
+
+    /* Runs the benchmark in this process. The peak resident set size is the one of the whole run so far */
+    report run_here(const benchmark &work) {
+        measurement result = work.run();
+        struct rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        return {true, result, usage.ru_maxrss};
+    }
+
+    std::string label(const benchmark &work) {
+        return work.container + "/" + work.operation + "/" + work.key + "/" + work.distribution + "/" +
+               std::to_string(work.size);
+    }
+
+    /* Parses a list of sizes separated by commas, ignoring the zeros */
+    std::vector<size_t> parse_sizes(const char *text) {
+        std::vector<size_t> sizes;
+        while (*text != '\0') {
+            char *end;
+            size_t size = std::strtoull(text, &end, 10);
+            if (end == text)
+                break;
+            if (size > 0)
+                sizes.push_back(size);
+            text = *end == ',' ? end + 1 : end;
+        }
+        return sizes;
+    }
+
+    void usage(const char *program) {
+        std::fprintf(stderr,
+                     "usage: %s [--quick] [--sizes n,n,...] [--min-ops n] [--filter text] [--list] [--no-fork] [--help]\n"
+                     "  --quick        small sizes and operation counts, for a smoke run\n"
+                     "  --sizes        the container sizes, default 1000,100000,1000000\n"
+                     "  --min-ops      the minimum number of timed operations per benchmark, default 1000000\n"
+                     "  --filter       run only the benchmarks whose container/operation/key/distribution/size contains the text\n"
+                     "  --list         print the names of the benchmarks and exit\n"
+                     "  --no-fork      run every benchmark in this process, peak_rss_kb then covers the whole run\n"
+                     "The results are written to the standard output as JSON.\n",
+                     program);
+    }
+}
+
+int main(int argc, char **argv) {
+    options settings{{1000, 100000, 1000000}, 1000000};
+    std::string filter;
+    bool list_only = false, isolate = true;
+
+    for (int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if (std::strcmp(argv[i], "--quick") == 0) {
+            settings.sizes = {1000, 10000};
+            settings.min_operations = 100000;
+        } else if (std::strcmp(argv[i], "--sizes") == 0 && has_value) {
+            settings.sizes = parse_sizes(argv[++i]);
+        } else if (std::strcmp(argv[i], "--min-ops") == 0 && has_value) {
+            settings.min_operations = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--filter") == 0 && has_value) {
+            filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--list") == 0) {
+            list_only = true;
+        } else if (std::strcmp(argv[i], "--no-fork") == 0) {
+            isolate = false;
+        } else if (std::strcmp(argv[i], "--help") == 0) {
+            usage(argv[0]);
+            return 0;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (settings.min_operations == 0)
+        settings.min_operations = 1;
+
+    registry benchmarks;
+    register_containers(benchmarks, settings);
+    register_sets(benchmarks, settings);
+    register_parallel(benchmarks, settings);
+
+    if (list_only) {
+        for (const benchmark &work : benchmarks)
+            if (label(work).find(filter) != std::string::npos)
+                std::printf("%s\n", label(work).c_str());
+        return 0;
+    }
+
+    std::printf("{\n  \"context\": {\"compiler\": \"%s\", \"hardware_threads\": %u, \"min_operations\": %zu},\n"
+                "  \"benchmarks\": [",
+#if defined(__VERSION__)
+                __VERSION__,
+#else
+                "unknown",
+#endif
+                std::thread::hardware_concurrency(), settings.min_operations);
+
+    bool first = true, failed = false;
+    for (const benchmark &work : benchmarks) {
+        if (label(work).find(filter) == std::string::npos)
+            continue;
+
+        std::fprintf(stderr, "%s\n", label(work).c_str());
+        std::fflush(stdout);
+        report outcome = isolate ? run_isolated(work) : run_here(work);
+        if (!outcome.valid) {
+            std::fprintf(stderr, "  failed\n");
+            failed = true;
+            continue;
+        }
+
+        double operations = static_cast<double>(outcome.result.operations);
+        double seconds = outcome.result.seconds;
+        std::printf("%s\n    {\"container\": \"%s\", \"operation\": \"%s\", \"key\": \"%s\", \"distribution\": \"%s\", "
+                    "\"size\": %zu, \"operations\": %zu, \"seconds\": %.6f, \"ns_per_op\": %.3f, "
+                    "\"ops_per_second\": %.0f, \"peak_rss_kb\": %ld}",
+                    first ? "" : ",", work.container.c_str(), work.operation.c_str(), work.key.c_str(),
+                    work.distribution.c_str(), work.size, outcome.result.operations, seconds,
+                    operations > 0 ? seconds * 1e9 / operations : 0.0, seconds > 0 ? operations / seconds : 0.0,
+                    outcome.peak_rss_kb);
+        first = false;
+    }
+    std::printf("\n  ]\n}\n");
+    return failed ? 1 : 0;
+}
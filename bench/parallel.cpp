@@ -0,0 +1,71 @@
+//
+// Created by gvisan on 18.10.2026.
+//
+
+#include<algorithm> //for max
+#include<string>
+#include<thread> //for hardware_concurrency
+#include<dsl/hashmap.h>
+#include<dsl/parallel.h>
+#include<dsl/set.h>
+#include"bench.h"
+
+namespace dsl_bench {
+    namespace {
+
+        using key = uint64_t;
+
+        /* Sums the keys of a full container, with a sequential loop and with parallel_reduce at 1, 2, 4... threads */
+        template<class container, class make_function, class key_function>
+        void add_scan(registry &benchmarks, const std::string &name, make_function make, key_function key_of,
+                      const options &settings) {
+            size_t max_threads = std::max<size_t>(8, 2 * std::thread::hardware_concurrency());
+            for (size_t n : settings.sizes) {
+                size_t reps = repetitions(n, settings);
+
+                benchmarks.push_back({name, "reduce", key_name<key>(), "uniform", n, [=]() {
+                    container structure = make(n);
+                    key sum = 0;
+                    double seconds = time([&]() {
+                        for (size_t r = 0; r < reps; r++)
+                            for (auto &element : structure)
+                                sum += key_of(element);
+                    });
+                    keep(sum);
+                    return measurement{n * reps, seconds};
+                }});
+
+                for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+                    std::string operation = "parallel_reduce_threads_" + std::to_string(threads);
+                    benchmarks.push_back({name, operation, key_name<key>(), "uniform", n, [=]() {
+                        container structure = make(n);
+                        dsl::thread_pool pool(static_cast<unsigned>(threads));
+                        key sum = 0;
+                        double seconds = time([&]() {
+                            for (size_t r = 0; r < reps; r++)
+                                sum += dsl::parallel_reduce(structure, key(0), [](key a, key b) { return a + b; },
+                                                            key_of, pool);
+                        });
+                        keep(sum);
+                        return measurement{n * reps, seconds};
+                    }});
+                }
+            }
+        }
+    }
+
+    void register_parallel(registry &benchmarks, const options &settings) {
+        add_scan<dsl::set<key>>(benchmarks, "dsl::set", [](size_t n) {
+            std::vector<key> keys = make_keys<key>(n, 1);
+            std::sort(keys.begin(), keys.end());
+            return dsl::set<key>(keys.begin(), keys.end());
+        }, [](key value) { return value; }, settings);
+
+        add_scan<dsl::hashmap<key, key>>(benchmarks, "dsl::hashmap", [](size_t n) {
+            dsl::hashmap<key, key> structure(n);
+            for (key value : make_keys<key>(n, 1))
+                structure.insert({value, value});
+            return structure;
+        }, [](const std::pair<key, key> &element) { return element.second; }, settings);
+    }
+}
@@ -0,0 +1,532 @@
+//
+// Created by gvisan on 18.10.2026.
+//
+
+#include<algorithm> //for sort, min
+#include<atomic>
+#include<mutex> //for unique_lock
+#include<set>
+#include<shared_mutex>
+#include<string>
+#include<thread>
+#include<dsl/btree_set.h>
+#include<dsl/concurrent_set.h>
+#include<dsl/flat_set.h>
+#include<dsl/frozen_set.h>
+#include<dsl/persistent_set.h>
+#include<dsl/set.h>
+#include"bench.h"
+
+namespace dsl_bench {
+    namespace {
+
+        using key = int;
+
+        /* Returns the keys sorted in ascending order */
+        std::vector<key> sorted_keys(size_t n, uint64_t seed) {
+            std::vector<key> keys = make_keys<key>(n, seed);
+            std::sort(keys.begin(), keys.end());
+            return keys;
+        }
+
+        template<class container>
+        container build(const std::vector<key> &keys) {
+            container ans;
+            for (key value : keys)
+                ans.insert(value);
+            return ans;
+        }
+
+        /* In-place union, intersection and difference of two sets of n keys that share half their keys,
+         * against copying one set and inserting, finding or erasing the keys of the other one by one */
+        void add_algebra(registry &benchmarks, const options &settings) {
+            for (size_t n : settings.sizes) {
+                size_t reps = repetitions(2 * n, settings);
+
+                /* The first set holds keys [0, n) of a key sequence, the second set holds keys [n/2, n + n/2) */
+                auto halves = [n]() {
+                    std::vector<key> keys = make_keys<key>(n + n / 2, 5);
+                    return std::make_pair(std::vector<key>(keys.begin(), keys.begin() + n),
+                                          std::vector<key>(keys.begin() + n / 2, keys.end()));
+                };
+
+                const char *operations[] = {"union", "intersection", "difference"};
+                for (int operation = 0; operation < 3; operation++) {
+                    benchmarks.push_back({"dsl::set", operations[operation], key_name<key>(), "uniform", n, [=]() {
+                        auto keys = halves();
+                        dsl::set<key> a = build<dsl::set<key>>(keys.first), b = build<dsl::set<key>>(keys.second);
+                        std::vector<dsl::set<key>> left(reps, a), right(reps, b);
+                        double seconds = time([&]() {
+                            for (size_t r = 0; r < reps; r++) {
+                                if (operation == 0)
+                                    left[r].set_union(right[r]);
+                                else if (operation == 1)
+                                    left[r].set_intersection(right[r]);
+                                else
+                                    left[r].set_difference(right[r]);
+                            }
+                        });
+                        return measurement{2 * n * reps, seconds};
+                    }});
+
+                    std::string baseline = std::string(operations[operation]) + "_one_by_one";
+                    benchmarks.push_back({"dsl::set", baseline, key_name<key>(), "uniform", n, [=]() {
+                        auto keys = halves();
+                        dsl::set<key> a = build<dsl::set<key>>(keys.first), b = build<dsl::set<key>>(keys.second);
+                        std::vector<dsl::set<key>> left(reps, a);
+                        double seconds = time([&]() {
+                            for (dsl::set<key> &target : left) {
+                                if (operation == 0) {
+                                    for (key value : b)
+                                        target.insert(value);
+                                } else if (operation == 1) {
+                                    dsl::set<key> common;
+                                    for (key value : b)
+                                        if (target.find(value) != target.end())
+                                            common.insert(value);
+                                    target.swap(common);
+                                } else {
+                                    for (key value : b)
+                                        target.erase(target.find(value));
+                                }
+                            }
+                        });
+                        return measurement{2 * n * reps, seconds};
+                    }});
+                }
+            }
+        }
+
+        /* Building a set from sorted keys, against inserting them one by one */
+        void add_bulk_build(registry &benchmarks, const options &settings) {
+            for (size_t n : settings.sizes) {
+                size_t reps = repetitions(n, settings);
+
+                benchmarks.push_back({"dsl::set", "build_sorted", key_name<key>(), "sorted", n, [=]() {
+                    std::vector<key> keys = sorted_keys(n, 1);
+                    std::vector<dsl::set<key>> built;
+                    built.reserve(reps);
+                    double seconds = time([&]() {
+                        for (size_t r = 0; r < reps; r++)
+                            built.emplace_back(keys.begin(), keys.end());
+                    });
+                    return measurement{n * reps, seconds};
+                }});
+
+                benchmarks.push_back({"dsl::set", "insert_sorted", key_name<key>(), "sorted", n, [=]() {
+                    std::vector<key> keys = sorted_keys(n, 1);
+                    std::vector<dsl::set<key>> built(reps);
+                    double seconds = time([&]() {
+                        for (dsl::set<key> &structure : built)
+                            for (key value : keys)
+                                structure.insert(value);
+                    });
+                    return measurement{n * reps, seconds};
+                }});
+
+                benchmarks.push_back({"std::set", "build_sorted", key_name<key>(), "sorted", n, [=]() {
+                    std::vector<key> keys = sorted_keys(n, 1);
+                    std::vector<std::set<key>> built;
+                    built.reserve(reps);
+                    double seconds = time([&]() {
+                        for (size_t r = 0; r < reps; r++)
+                            built.emplace_back(keys.begin(), keys.end());
+                    });
+                    return measurement{n * reps, seconds};
+                }});
+
+                /* Merging n sorted keys into a set of n other keys */
+                benchmarks.push_back({"dsl::set", "insert_sorted_range", key_name<key>(), "sorted", n, [=]() {
+                    std::vector<key> keys = make_keys<key>(2 * n, 1);
+                    std::vector<key> added(keys.begin() + n, keys.end());
+                    std::sort(added.begin(), added.end());
+                    keys.resize(n);
+                    std::vector<dsl::set<key>> built(reps, build<dsl::set<key>>(keys));
+                    double seconds = time([&]() {
+                        for (dsl::set<key> &structure : built)
+                            structure.insert_sorted_range(added.begin(), added.end());
+                    });
+                    return measurement{n * reps, seconds};
+                }});
+            }
+        }
+
+        /* Taking a snapshot of a persistent_set and changing it, against copying a dsl::set and changing the copy */
+        void add_snapshot(registry &benchmarks, const options &settings) {
+            for (size_t n : settings.sizes) {
+                size_t reps = std::max<size_t>(1, std::min<size_t>(settings.min_operations / n, 10000));
+
+                benchmarks.push_back({"dsl::persistent_set", "snapshot_insert", key_name<key>(), "uniform", n, [=]() {
+                    std::vector<key> keys = make_keys<key>(n + reps, 1);
+                    dsl::persistent_set<key> structure;
+                    for (size_t i = 0; i < n; i++)
+                        structure.insert(keys[i]);
+                    std::vector<dsl::persistent_set<key>> versions;
+                    versions.reserve(reps);
+                    double seconds = time([&]() {
+                        for (size_t r = 0; r < reps; r++) {
+                            versions.push_back(structure.snapshot());
+                            structure.insert(keys[n + r]);
+                        }
+                    });
+                    return measurement{reps, seconds};
+                }});
+
+                benchmarks.push_back({"dsl::set", "copy_insert", key_name<key>(), "uniform", n, [=]() {
+                    std::vector<key> keys = make_keys<key>(n + reps, 1);
+                    dsl::set<key> structure = build<dsl::set<key>>(std::vector<key>(keys.begin(), keys.begin() + n));
+                    std::vector<dsl::set<key>> versions;
+                    versions.reserve(reps);
+                    double seconds = time([&]() {
+                        for (size_t r = 0; r < reps; r++) {
+                            versions.push_back(structure);
+                            structure.insert(keys[n + r]);
+                        }
+                    });
+                    return measurement{reps, seconds};
+                }});
+            }
+        }
+
+        /* A stage of a pipeline, that takes a set by value and hands it to the next stage */
+        template<class container>
+        container pass(container structure) {
+            keep(structure);
+            return structure;
+        }
+
+        /* Handing a set of n keys from stage to stage by value, by moving it and by copying it */
+        template<class container>
+        void add_handoff(registry &benchmarks, const std::string &name, const options &settings) {
+            for (size_t n : settings.sizes) {
+                size_t copies = std::max<size_t>(1, std::min<size_t>(settings.min_operations / n, 1000));
+
+                benchmarks.push_back({name, "handoff_move", key_name<key>(), "uniform", n, [=]() {
+                    auto structure = build<container>(make_keys<key>(n, 1));
+                    double seconds = time([&]() {
+                        for (size_t r = 0; r < settings.min_operations; r++) {
+                            container next = pass(std::move(structure));
+                            structure = std::move(next);
+                        }
+                    });
+                    keep(structure);
+                    return measurement{settings.min_operations, seconds};
+                }});
+
+                benchmarks.push_back({name, "handoff_copy", key_name<key>(), "uniform", n, [=]() {
+                    auto structure = build<container>(make_keys<key>(n, 1));
+                    double seconds = time([&]() {
+                        for (size_t r = 0; r < copies; r++) {
+                            container next = pass(structure);
+                            structure = std::move(next);
+                        }
+                    });
+                    keep(structure);
+                    return measurement{copies, seconds};
+                }});
+            }
+        }
+
+        /* A std::set guarded by a reader-writer lock, the usual alternative to a concurrent set */
+        struct locked_set {
+            std::set<key> structure;
+            mutable std::shared_mutex lock;
+
+            bool find(key value) const {
+                std::shared_lock<std::shared_mutex> guard(lock);
+                return structure.find(value) != structure.end();
+            }
+
+            void insert(key value) {
+                std::unique_lock<std::shared_mutex> guard(lock);
+                structure.insert(value);
+            }
+
+            void erase(key value) {
+                std::unique_lock<std::shared_mutex> guard(lock);
+                structure.erase(value);
+            }
+        };
+
+        struct concurrent_driver {
+            dsl::concurrent_set<key> structure;
+
+            bool find(key value) const {
+                return structure.find(value) != structure.end();
+            }
+
+            void insert(key value) {
+                structure.insert(value);
+            }
+
+            void erase(key value) {
+                structure.erase(value);
+            }
+        };
+
+        /* Runs operations split between the threads: 90% find, 5% insert and 5% erase, over keys [0, 2n) */
+        template<class container>
+        measurement run_mixed(size_t n, size_t threads, size_t operations) {
+            container shared;
+            for (size_t i = 0; i < n; i++)
+                shared.insert(static_cast<key>(2 * i));
+
+            std::atomic<size_t> found(0);
+            std::vector<std::thread> workers;
+            double seconds = time([&]() {
+                for (size_t t = 0; t < threads; t++) {
+                    workers.emplace_back([&, t]() {
+                        xorshift generator(t + 11);
+                        size_t hits = 0;
+                        for (size_t i = 0; i < operations / threads; i++) {
+                            uint64_t draw = generator.next();
+                            key value = static_cast<key>((draw >> 8u) % (2 * n));
+                            unsigned kind = static_cast<unsigned>(draw % 100);
+                            if (kind < 90)
+                                hits += shared.find(value);
+                            else if (kind < 95)
+                                shared.insert(value);
+                            else
+                                shared.erase(value);
+                        }
+                        found += hits;
+                    });
+                }
+                for (std::thread &worker : workers)
+                    worker.join();
+            });
+            keep(found);
+            return measurement{operations / threads * threads, seconds};
+        }
+
+        void add_concurrent(registry &benchmarks, const options &settings) {
+            size_t max_threads = std::max<size_t>(8, 2 * std::thread::hardware_concurrency());
+            for (size_t n : settings.sizes) {
+                size_t operations = std::max<size_t>(settings.min_operations, n);
+                for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+                    std::string operation = "mixed_90_5_5_threads_" + std::to_string(threads);
+                    benchmarks.push_back({"dsl::concurrent_set", operation, key_name<key>(), "uniform", n, [=]() {
+                        return run_mixed<concurrent_driver>(n, threads, operations);
+                    }});
+                    benchmarks.push_back({"std::set+shared_mutex", operation, key_name<key>(), "uniform", n, [=]() {
+                        return run_mixed<locked_set>(n, threads, operations);
+                    }});
+                }
+            }
+        }
+
+        /* Readers of a persistent_set take a snapshot and search it, while the writer keeps modifying the set */
+        struct snapshot_driver {
+            dsl::persistent_set<key> structure;
+
+            size_t find_batch(const key *values, size_t n) const {
+                dsl::persistent_set<key> version = structure.snapshot();
+                size_t hits = 0;
+                for (size_t i = 0; i < n; i++)
+                    hits += version.find(values[i]) != version.end();
+                return hits;
+            }
+
+            void insert(key value) {
+                structure.insert(value);
+            }
+
+            void erase(key value) {
+                structure.erase(structure.find(value));
+            }
+        };
+
+        /* Readers of a locked std::set take the shared lock for every search */
+        struct locked_reader_driver : locked_set {
+            size_t find_batch(const key *values, size_t n) const {
+                size_t hits = 0;
+                for (size_t i = 0; i < n; i++)
+                    hits += find(values[i]);
+                return hits;
+            }
+        };
+
+        /* Runs the finds split between the reader threads, in batches of 64 keys over [0, 2n), while one more thread
+         * inserts and erases keys until the readers are done. Only the finds are counted */
+        template<class container>
+        measurement run_readers(size_t n, size_t readers, size_t operations) {
+            constexpr size_t batch = 64;
+            container shared;
+            for (size_t i = 0; i < n; i++)
+                shared.insert(static_cast<key>(2 * i));
+
+            std::atomic<bool> done(false);
+            std::thread writer([&]() {
+                xorshift generator(7);
+                while (!done.load(std::memory_order_relaxed)) {
+                    uint64_t draw = generator.next();
+                    key value = static_cast<key>((draw >> 8u) % (2 * n));
+                    if (draw & 1u)
+                        shared.insert(value);
+                    else
+                        shared.erase(value);
+                }
+            });
+
+            std::atomic<size_t> found(0);
+            std::vector<std::thread> workers;
+            size_t batches = std::max<size_t>(1, operations / readers / batch);
+            double seconds = time([&]() {
+                for (size_t t = 0; t < readers; t++) {
+                    workers.emplace_back([&, t]() {
+                        xorshift generator(t + 11);
+                        key values[batch];
+                        size_t hits = 0;
+                        for (size_t b = 0; b < batches; b++) {
+                            for (key &value : values)
+                                value = static_cast<key>((generator.next() >> 8u) % (2 * n));
+                            hits += shared.find_batch(values, batch);
+                        }
+                        found += hits;
+                    });
+                }
+                for (std::thread &worker : workers)
+                    worker.join();
+            });
+            done = true;
+            writer.join();
+            keep(found);
+            return measurement{batches * batch * readers, seconds};
+        }
+
+        void add_snapshot_readers(registry &benchmarks, const options &settings) {
+            size_t max_readers = std::max<size_t>(8, 2 * std::thread::hardware_concurrency());
+            for (size_t n : settings.sizes) {
+                size_t operations = std::max<size_t>(settings.min_operations, n);
+                for (size_t readers = 1; readers <= max_readers; readers *= 2) {
+                    std::string operation = "find_with_writer_readers_" + std::to_string(readers);
+                    benchmarks.push_back({"dsl::persistent_set", operation, key_name<key>(), "uniform", n, [=]() {
+                        return run_readers<snapshot_driver>(n, readers, operations);
+                    }});
+                    benchmarks.push_back({"std::set+shared_mutex", operation, key_name<key>(), "uniform", n, [=]() {
+                        return run_readers<locked_reader_driver>(n, readers, operations);
+                    }});
+                }
+            }
+        }
+
+        /* lower_bound on a frozen_set, against the other ordered sets. Large sizes can be given with --sizes */
+        void add_frozen(registry &benchmarks, const options &settings) {
+            for (size_t n : settings.sizes) {
+                size_t probes = std::max(n, settings.min_operations);
+
+                auto measure = [=](auto &structure) {
+                    std::vector<key> queries = make_probes(make_keys<key>(n, 9), distribution::uniform, probes, 3);
+                    size_t sum = 0;
+                    double seconds = time([&]() {
+                        for (key value : queries) {
+                            auto position = structure.lower_bound(value);
+                            sum += position != structure.end();
+                        }
+                    });
+                    keep(sum);
+                    return measurement{queries.size(), seconds};
+                };
+
+                benchmarks.push_back({"dsl::frozen_set", "lower_bound", key_name<key>(), "uniform", n, [=]() {
+                    std::vector<key> keys = sorted_keys(n, 1);
+                    dsl::frozen_set<key> structure(keys.begin(), keys.end());
+                    return measure(structure);
+                }});
+                benchmarks.push_back({"dsl::set", "lower_bound", key_name<key>(), "uniform", n, [=]() {
+                    std::vector<key> keys = sorted_keys(n, 1);
+                    dsl::set<key> structure(keys.begin(), keys.end());
+                    return measure(structure);
+                }});
+                benchmarks.push_back({"dsl::btree_set", "lower_bound", key_name<key>(), "uniform", n, [=]() {
+                    auto structure = build<dsl::btree_set<key>>(make_keys<key>(n, 1));
+                    return measure(structure);
+                }});
+                benchmarks.push_back({"std::set", "lower_bound", key_name<key>(), "uniform", n, [=]() {
+                    std::vector<key> keys = sorted_keys(n, 1);
+                    std::set<key> structure(keys.begin(), keys.end());
+                    return measure(structure);
+                }});
+            }
+        }
+
+        /* find_many on sorted probes, against one find per probe. The dense probes visit every key of the set,
+         * the sparse ones every 64th key */
+        void add_finger(registry &benchmarks, const options &settings) {
+            for (size_t n : settings.sizes) {
+                for (size_t stride : {size_t(1), size_t(64)}) {
+                    std::string order = stride == 1 ? "dense" : "sparse";
+                    size_t reps = repetitions(n / stride + 1, settings);
+
+                    auto probes = [=]() {
+                        std::vector<key> keys = sorted_keys(n, 1), ans;
+                        for (size_t i = 0; i < n; i += stride)
+                            ans.push_back(keys[i]);
+                        return ans;
+                    };
+
+                    benchmarks.push_back({"dsl::set", "find_many", key_name<key>(), order, n, [=]() {
+                        std::vector<key> keys = sorted_keys(n, 1), queries = probes();
+                        dsl::set<key> structure(keys.begin(), keys.end());
+                        std::vector<dsl::set<key>::iterator> results(queries.size(), structure.end());
+                        double seconds = time([&]() {
+                            for (size_t r = 0; r < reps; r++)
+                                structure.find_many(queries.begin(), queries.end(), results.begin());
+                        });
+                        return measurement{queries.size() * reps, seconds};
+                    }});
+
+                    benchmarks.push_back({"dsl::set", "find", key_name<key>(), order, n, [=]() {
+                        std::vector<key> keys = sorted_keys(n, 1), queries = probes();
+                        dsl::set<key> structure(keys.begin(), keys.end());
+                        std::vector<dsl::set<key>::iterator> results(queries.size(), structure.end());
+                        double seconds = time([&]() {
+                            for (size_t r = 0; r < reps; r++)
+                                for (size_t i = 0; i < queries.size(); i++)
+                                    results[i] = structure.find(queries[i]);
+                        });
+                        return measurement{queries.size() * reps, seconds};
+                    }});
+                }
+            }
+        }
+
+        /* Building a small set and finding every key, at the sizes where a flat_set is meant to be used */
+        template<class container>
+        void add_small(registry &benchmarks, const std::string &name, const options &settings) {
+            for (size_t n : {1, 4, 16, 32, 64, 256, 1000}) {
+                size_t reps = repetitions(n, settings);
+                benchmarks.push_back({name, "insert_find", key_name<key>(), "uniform", n, [=]() {
+                    std::vector<key> keys = make_keys<key>(n, 1);
+                    size_t found = 0;
+                    double seconds = time([&]() {
+                        for (size_t r = 0; r < reps; r++) {
+                            container structure;
+                            for (key value : keys)
+                                structure.insert(value);
+                            for (key value : keys)
+                                found += structure.find(value) != structure.end();
+                        }
+                    });
+                    keep(found);
+                    return measurement{n * reps, seconds};
+                }});
+            }
+        }
+    }
+
+    void register_sets(registry &benchmarks, const options &settings) {
+        add_algebra(benchmarks, settings);
+        add_bulk_build(benchmarks, settings);
+        add_snapshot(benchmarks, settings);
+        add_handoff<dsl::set<key>>(benchmarks, "dsl::set", settings);
+        add_handoff<std::set<key>>(benchmarks, "std::set", settings);
+        add_concurrent(benchmarks, settings);
+        add_snapshot_readers(benchmarks, settings);
+        add_frozen(benchmarks, settings);
+        add_finger(benchmarks, settings);
+        add_small<dsl::flat_set<key>>(benchmarks, "dsl::flat_set", settings);
+        add_small<dsl::set<key>>(benchmarks, "dsl::set", settings);
+        add_small<std::set<key>>(benchmarks, "std::set", settings);
+    }
+}
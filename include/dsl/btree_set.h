@@ -0,0 +1,580 @@
+//
+// Created by gvisan on 18.10.2026.
+//
+
+#ifndef DSL_BTREE_SET_H
+#define DSL_BTREE_SET_H
+
+#include<algorithm> //for lower_bound, upper_bound, copy
+#include<cstddef> //for size_t
+#include<functional> //for less
+#include<iterator> //for std::bidirectional_iterator_tag
+#include<type_traits> //for is_arithmetic
+#include<utility> //for swap
+
+namespace dsl {
+
+    /**
+     * This class is an implementation of an ordered set using a B+ tree.
+     *
+     * The keys are kept in wide nodes of a few cache lines, so a lookup touches few nodes and there is almost no
+     * memory overhead per key. The leaves are linked, iterating goes from one leaf to the next without going up the tree.
+     * Arithmetic keys ordered by std::less are searched inside a node with a branchless scan over the keys of the node,
+     * which the compiler turns into SIMD comparisons at -O3 (GCC does not vectorize it at -O2).
+     *
+     * @tparam key The type of the value of an entry in the set. It must be default constructible and copy assignable.
+     * @tparam compare A binary predicate that defines a strict weak ordering, used to order the elements.\n The expression compare(a,b) shall return true if a is considered to go before b.
+     */
+    template<class key, class compare=std::less<key>>
+    class btree_set {
+    private:
+
+        /* The number of bytes used by the keys of a node, four cache lines */
+        static constexpr size_t node_bytes = 256;
+
+        /* The maximum number of keys in a node */
+        static constexpr size_t capacity = node_bytes / sizeof(key) < 8 ? 8 : node_bytes / sizeof(key);
+
+        /* The minimum number of keys in a node that is not the root */
+        static constexpr size_t min_keys = capacity / 2;
+
+        /* The maximum height of the tree, every level multiplies the number of keys by at least min_keys */
+        static constexpr size_t max_height = 64;
+
+        /* Whether the keys of a node are searched with a branchless scan instead of a binary search */
+        static constexpr bool linear_search = std::is_arithmetic<key>::value &&
+                                              (std::is_same<compare, std::less<key>>::value ||
+                                               std::is_same<compare, std::less<>>::value);
+
+        /* The part common to all the nodes */
+        struct node {
+            /* The number of keys in the node */
+            size_t count = 0;
+
+            /* The keys, in order */
+            key keys[capacity]{};
+        };
+
+        /* A leaf node, it holds the keys of the set */
+        struct leaf : public node {
+            /* The neighbouring leaves, used by the iterators */
+            leaf *previous = nullptr, *next = nullptr;
+        };
+
+        /* An inner node. All the keys in children[i] go before keys[i], the keys in children[i+1] do not */
+        struct inner : public node {
+            node *children[capacity + 1]{};
+        };
+
+        /* An inner node visited on the way to a leaf, and the index of the son that was taken */
+        struct path_entry {
+            inner *here;
+            size_t index;
+        };
+
+        /* The root of the tree, nullptr if the set is empty */
+        node *root;
+
+        /* The number of inner levels above the leaves */
+        size_t height;
+
+        /* The first and the last leaf */
+        leaf *first, *last;
+
+        /* The number of keys in the set */
+        size_t count;
+
+        /*The comparator, used to compare keys */
+        compare comparator;
+
+        /* Returns the number of keys of the node that go before the value */
+        size_t count_before(const node *here, const key &value) {
+            if constexpr (linear_search) {
+                const key *keys = here->keys, bound = value; // Local copies, so the loop does not reload them
+                size_t used = here->count, ans = 0;
+                for (size_t i = 0; i < used; i++)
+                    ans += keys[i] < bound;
+                return ans;
+            } else {
+                return std::lower_bound(here->keys, here->keys + here->count, value, comparator) - here->keys;
+            }
+        }
+
+        /* Returns the number of keys of the node that do not go after the value */
+        size_t count_not_after(const node *here, const key &value) {
+            if constexpr (linear_search) {
+                const key *keys = here->keys, bound = value;
+                size_t used = here->count, ans = 0;
+                for (size_t i = 0; i < used; i++)
+                    ans += !(bound < keys[i]);
+                return ans;
+            } else {
+                return std::upper_bound(here->keys, here->keys + here->count, value, comparator) - here->keys;
+            }
+        }
+
+        /* Returns the leaf that may hold the value. If a path is given, the visited inner nodes are stored in it */
+        leaf *descend(const key &value, path_entry *path) {
+            node *here = root;
+            for (size_t depth = 0; depth < height; depth++) {
+                inner *parent = static_cast<inner *>(here);
+                size_t index = count_not_after(parent, value);
+                if (path != nullptr)
+                    path[depth] = {parent, index};
+                here = parent->children[index];
+            }
+            return static_cast<leaf *>(here);
+        }
+
+        /* Insert the key at the given position of the node, the node must not be full */
+        static void insert_key(node *here, size_t position, const key &value) {
+            std::copy_backward(here->keys + position, here->keys + here->count, here->keys + here->count + 1);
+            here->keys[position] = value;
+            here->count++;
+        }
+
+        /* Insert the separator and the new node that follows it into the parents of the leaf, splitting them if they are full */
+        void insert_into_parents(path_entry *path, key separator, node *right) {
+            for (size_t depth = height; depth > 0; depth--) {
+                inner *parent = path[depth - 1].here;
+                size_t index = path[depth - 1].index; // The separator goes at keys[index], the node at children[index+1]
+
+                if (parent->count < capacity) {
+                    std::copy_backward(parent->children + index + 1, parent->children + parent->count + 1,
+                                       parent->children + parent->count + 2);
+                    parent->children[index + 1] = right;
+                    insert_key(parent, index, separator);
+                    return;
+                }
+
+                /* The parent is full, so put all the keys and sons together and split them in two halves */
+                key keys[capacity + 1];
+                node *children[capacity + 2];
+                std::copy(parent->keys, parent->keys + index, keys);
+                keys[index] = separator;
+                std::copy(parent->keys + index, parent->keys + capacity, keys + index + 1);
+                std::copy(parent->children, parent->children + index + 1, children);
+                children[index + 1] = right;
+                std::copy(parent->children + index + 1, parent->children + capacity + 1, children + index + 2);
+
+                size_t middle = (capacity + 1) / 2; // This key goes up
+                inner *sibling = new inner();
+                std::copy(keys, keys + middle, parent->keys);
+                std::copy(children, children + middle + 1, parent->children);
+                parent->count = middle;
+                std::copy(keys + middle + 1, keys + capacity + 1, sibling->keys);
+                std::copy(children + middle + 1, children + capacity + 2, sibling->children);
+                sibling->count = capacity - middle;
+
+                separator = keys[middle];
+                right = sibling;
+            }
+
+            /* The root was split, so the tree grows by one level */
+            inner *new_root = new inner();
+            new_root->keys[0] = separator;
+            new_root->children[0] = root;
+            new_root->children[1] = right;
+            new_root->count = 1;
+            root = new_root;
+            height++;
+        }
+
+        /* Move the last key of the left sibling of the son at the given index to it */
+        void borrow_from_left(inner *parent, size_t index, bool is_leaf) {
+            node *here = parent->children[index], *left = parent->children[index - 1];
+            std::copy_backward(here->keys, here->keys + here->count, here->keys + here->count + 1);
+
+            if (is_leaf) {
+                here->keys[0] = left->keys[left->count - 1];
+                parent->keys[index - 1] = here->keys[0];
+            } else { // Rotate the key through the parent, together with the last son of the sibling
+                inner *in = static_cast<inner *>(here), *in_left = static_cast<inner *>(left);
+                std::copy_backward(in->children, in->children + in->count + 1, in->children + in->count + 2);
+                in->children[0] = in_left->children[left->count];
+                here->keys[0] = parent->keys[index - 1];
+                parent->keys[index - 1] = left->keys[left->count - 1];
+            }
+            here->count++;
+            left->count--;
+        }
+
+        /* Move the first key of the right sibling of the son at the given index to it */
+        void borrow_from_right(inner *parent, size_t index, bool is_leaf) {
+            node *here = parent->children[index], *right = parent->children[index + 1];
+
+            if (is_leaf) {
+                here->keys[here->count] = right->keys[0];
+                std::copy(right->keys + 1, right->keys + right->count, right->keys);
+                parent->keys[index] = right->keys[0];
+            } else { // Rotate the key through the parent, together with the first son of the sibling
+                inner *in = static_cast<inner *>(here), *in_right = static_cast<inner *>(right);
+                here->keys[here->count] = parent->keys[index];
+                in->children[here->count + 1] = in_right->children[0];
+                parent->keys[index] = right->keys[0];
+                std::copy(right->keys + 1, right->keys + right->count, right->keys);
+                std::copy(in_right->children + 1, in_right->children + right->count + 1, in_right->children);
+            }
+            here->count++;
+            right->count--;
+        }
+
+        /* Merge the son at index+1 into the son at index, removing their separator from the parent */
+        void merge(inner *parent, size_t index, bool is_leaf) {
+            node *left = parent->children[index], *right = parent->children[index + 1];
+
+            if (is_leaf) {
+                leaf *l = static_cast<leaf *>(left), *r = static_cast<leaf *>(right);
+                std::copy(right->keys, right->keys + right->count, left->keys + left->count);
+                left->count += right->count;
+                l->next = r->next;
+                if (r->next != nullptr)
+                    r->next->previous = l;
+                else
+                    last = l;
+                delete r;
+            } else {
+                inner *l = static_cast<inner *>(left), *r = static_cast<inner *>(right);
+                left->keys[left->count] = parent->keys[index];
+                std::copy(right->keys, right->keys + right->count, left->keys + left->count + 1);
+                std::copy(r->children, r->children + right->count + 1, l->children + left->count + 1);
+                left->count += right->count + 1;
+                delete r;
+            }
+
+            std::copy(parent->keys + index + 1, parent->keys + parent->count, parent->keys + index);
+            std::copy(parent->children + index + 2, parent->children + parent->count + 1,
+                      parent->children + index + 1);
+            parent->count--;
+        }
+
+        /* Fix the nodes on the path that have too few keys, starting from the one at the given depth */
+        void rebalance(path_entry *path, size_t depth) {
+            for (; depth > 0; depth--) {
+                inner *parent = path[depth - 1].here;
+                size_t index = path[depth - 1].index;
+                bool is_leaf = depth == height;
+
+                if (parent->children[index]->count >= min_keys)
+                    return;
+
+                if (index > 0 && parent->children[index - 1]->count > min_keys) {
+                    borrow_from_left(parent, index, is_leaf);
+                    return;
+                }
+                if (index < parent->count && parent->children[index + 1]->count > min_keys) {
+                    borrow_from_right(parent, index, is_leaf);
+                    return;
+                }
+                merge(parent, index > 0 ? index - 1 : index, is_leaf);
+            }
+
+            /* The root lost its last key, so its only son becomes the root */
+            if (height > 0 && root->count == 0) {
+                inner *old_root = static_cast<inner *>(root);
+                root = old_root->children[0];
+                delete old_root;
+                height--;
+            }
+        }
+
+        /* Deep-copy the subtree at the given depth, linking the copied leaves after previous */
+        node *copy(const node *here, size_t depth, leaf *&previous) {
+            if (depth == height) {
+                leaf *copy_leaf = new leaf();
+                std::copy(here->keys, here->keys + here->count, copy_leaf->keys);
+                copy_leaf->count = here->count;
+
+                copy_leaf->previous = previous;
+                if (previous != nullptr)
+                    previous->next = copy_leaf;
+                else
+                    first = copy_leaf;
+                previous = copy_leaf;
+                return copy_leaf;
+            }
+
+            const inner *in = static_cast<const inner *>(here);
+            inner *copy_inner = new inner();
+            std::copy(here->keys, here->keys + here->count, copy_inner->keys);
+            copy_inner->count = here->count;
+            for (size_t i = 0; i <= here->count; i++)
+                copy_inner->children[i] = copy(in->children[i], depth + 1, previous);
+            return copy_inner;
+        }
+
+        /* Cleanup, recursively delete nodes */
+        void destroy_tree(node *here, size_t depth) {
+            if (depth == height) {
+                delete static_cast<leaf *>(here);
+                return;
+            }
+
+            inner *in = static_cast<inner *>(here);
+            for (size_t i = 0; i <= here->count; i++)
+                destroy_tree(in->children[i], depth + 1);
+            delete in;
+        }
+
+    public:
+
+        /**
+         * This is the iterator for the set.
+         * Iterating through the set returns the elements in the order defined by the compare predicate
+         */
+        struct iterator {
+            friend class btree_set;
+
+            using iterator_category = std::bidirectional_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = const key;
+            using pointer = const key *;
+            using reference = const key &;
+
+            iterator(leaf *here, size_t index, btree_set *structure) : h_leaf(here), h_index(index),
+                                                                        h_structure(structure) {
+
+            }
+
+            /** De-references the iterator. */
+            reference operator*() const {
+                return h_leaf->keys[h_index];
+            }
+
+            /** De-references the iterator. */
+            pointer operator->() {
+                return &h_leaf->keys[h_index];
+            }
+
+            /** Incrementing this iterator moves to the next key in the leaf, or to the first key of the next leaf. */
+            iterator &operator++() {
+                h_index++;
+                if (h_index == h_leaf->count) {
+                    h_leaf = h_leaf->next;
+                    h_index = 0;
+                }
+                return *this;
+            }
+
+            /** Post-increment, same as pre-increment, but return the value before the increment. */
+            iterator operator++(int) {
+                iterator tmp = *this;
+                ++*this;
+                return tmp;
+            }
+
+            /** Decrementing this iterator moves to the previous key in the leaf, or to the last key of the previous leaf. */
+            iterator &operator--() {
+                if (h_leaf == nullptr) { //If its the end iterator, jump to the greatest value in the tree
+                    h_leaf = h_structure->last;
+                    h_index = h_leaf->count - 1;
+                } else if (h_index == 0) {
+                    h_leaf = h_leaf->previous;
+                    h_index = h_leaf->count - 1;
+                } else {
+                    h_index--;
+                }
+                return *this;
+            }
+
+            /** Post-decrement, same as pre-decrement, but return the value before the decrement. */
+            iterator operator--(int) {
+                iterator tmp = *this;
+                --*this;
+                return tmp;
+            }
+
+            /** Checks if two iterators are equal. */
+            friend bool operator==(const iterator &a, const iterator &b) {
+                return a.h_leaf == b.h_leaf && a.h_index == b.h_index;
+            };
+
+            /** Checks if two iterators are not equal. */
+            friend bool operator!=(const iterator &a, const iterator &b) {
+                return a.h_leaf != b.h_leaf || a.h_index != b.h_index;
+            };
+
+        private:
+            /* The position of the iterator: a leaf and an index in it. The end iterator has no leaf */
+            leaf *h_leaf;
+            size_t h_index;
+
+            btree_set *h_structure;//a reference to the set
+        };
+
+        btree_set() : root(nullptr), height(0), first(nullptr), last(nullptr), count(0) {
+
+        }
+
+        /** Copy constructor, make a copy of the other set. */
+        btree_set(const btree_set &other) : root(nullptr), height(other.height), first(nullptr), last(nullptr),
+                                            count(other.count), comparator(other.comparator) {
+            if (other.root != nullptr) {
+                leaf *previous = nullptr;
+                root = copy(other.root, 0, previous);
+                last = previous;
+            }
+        }
+
+        /** Move constructor, takes the elements of the other set in constant time. The other set is left empty.
+         * The iterators of the other set are invalidated. */
+        btree_set(btree_set &&other) noexcept: btree_set() {
+            swap(other);
+        }
+
+        /** Assigns new contents to the set, replacing its current contents. Assigning from an rvalue takes its
+         * elements in constant time. */
+        btree_set &operator=(btree_set other) noexcept {
+            swap(other);
+            return *this;
+        }
+
+        /** Swaps the content of this set with another set.*/
+        void swap(btree_set &other) {
+            std::swap(root, other.root);
+            std::swap(height, other.height);
+            std::swap(first, other.first);
+            std::swap(last, other.last);
+            std::swap(count, other.count);
+            std::swap(comparator, other.comparator);
+        }
+
+        /** Destroys the set object.*/
+        ~btree_set() {
+            clear();
+        }
+
+        /** Returns an iterator to the first element in the set. */
+        iterator begin() {
+            return iterator(first, 0, this);
+        }
+
+        /** Returns an iterator that represents the end of the set. */
+        iterator end() {
+            return iterator(nullptr, 0, this);
+        }
+
+        /** Insert a new entry with the given key value. **/
+        void insert(const key &key_value) {
+            if (root == nullptr) {
+                leaf *here = new leaf();
+                here->keys[0] = key_value;
+                here->count = 1;
+                root = first = last = here;
+                count = 1;
+                return;
+            }
+
+            path_entry path[max_height];
+            leaf *here = descend(key_value, path);
+            size_t position = count_before(here, key_value);
+
+            if (position < here->count && !comparator(key_value, here->keys[position]))
+                return; // The key is already in the set
+
+            count++;
+            if (here->count < capacity) {
+                insert_key(here, position, key_value);
+                return;
+            }
+
+            /* The leaf is full, move its upper half to a new leaf */
+            leaf *right = new leaf();
+            std::copy(here->keys + min_keys, here->keys + capacity, right->keys);
+            right->count = capacity - min_keys;
+            here->count = min_keys;
+
+            right->next = here->next;
+            right->previous = here;
+            if (here->next != nullptr)
+                here->next->previous = right;
+            else
+                last = right;
+            here->next = right;
+
+            if (position <= min_keys)
+                insert_key(here, position, key_value);
+            else
+                insert_key(right, position - min_keys, key_value);
+
+            insert_into_parents(path, right->keys[0], right);
+        }
+
+        /** Returns an iterator that points to the element with the given key. If no element with the given key is found in the set, return the end iterator. */
+        iterator find(const key &key_value) {
+            iterator ans = lower_bound(key_value);
+            if (ans.h_leaf != nullptr && !comparator(key_value, *ans))
+                return ans;
+            return end();
+        }
+
+        /** Returns an iterator to the first element which is not considered to go before the given value. */
+        iterator lower_bound(const key &value) {
+            if (root == nullptr)
+                return end();
+
+            leaf *here = descend(value, nullptr);
+            size_t position = count_before(here, value);
+            if (position == here->count)
+                return iterator(here->next, 0, this);
+            return iterator(here, position, this);
+        }
+
+        /** Returns an iterator to the first element which is considered to go after the given value. */
+        iterator upper_bound(const key &value) {
+            if (root == nullptr)
+                return end();
+
+            leaf *here = descend(value, nullptr);
+            size_t position = count_not_after(here, value);
+            if (position == here->count)
+                return iterator(here->next, 0, this);
+            return iterator(here, position, this);
+        }
+
+        /** Removes an element from the set by iterator. Erasing the end iterator does nothing. */
+        void erase(iterator to_erase) {
+            if (to_erase.h_leaf == nullptr)
+                return;
+
+            path_entry path[max_height];
+            leaf *here = descend(*to_erase, path);
+            size_t position = to_erase.h_index;
+
+            std::copy(here->keys + position + 1, here->keys + here->count, here->keys + position);
+            here->count--;
+            count--;
+
+            if (here == root) {
+                if (here->count == 0) {
+                    delete here;
+                    root = first = last = nullptr;
+                }
+                return;
+            }
+            rebalance(path, height);
+        }
+
+        /** Returns the number of elements in the set. */
+        size_t size() const {
+            return count;
+        }
+
+        /** Checks if the container is empty. */
+        bool empty() const {
+            return count == 0;
+        }
+
+        /** Removes all the elements from the set. */
+        void clear() {
+            if (root != nullptr)
+                destroy_tree(root, 0);
+            root = nullptr;
+            first = last = nullptr;
+            height = 0;
+            count = 0;
+        }
+    };
+}
+
+#endif //DSL_BTREE_SET_H
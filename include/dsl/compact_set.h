@@ -0,0 +1,417 @@
+//
+// Created by gvisan on 18.10.2026.
+//
+
+#ifndef DSL_COMPACT_SET_H
+#define DSL_COMPACT_SET_H
+
+#include<cstddef> //for size_t
+#include<cstdint> //for uint32_t, uint64_t
+#include<functional> //for less
+#include<iterator> //for std::bidirectional_iterator_tag
+#include<limits> //for numeric_limits
+#include<stdexcept> //for length_error
+#include<utility> //for swap
+#include<vector>
+#include"seed.h"
+
+namespace dsl {
+
+    /**
+     * This class is an implementation of an ordered set using a treap data structure with a compact node layout.
+     *
+     * It has the same interface as dsl::set. The nodes are kept in one contiguous vector and linked with 32-bit
+     * indices instead of pointers, and erased nodes are reused through a free list. The priorities are not stored,
+     * they are a hash of the index of the node. For small keys a node takes 12 bytes plus the key, instead of
+     * 32 bytes plus the key and the overhead of a separate allocation.
+     *
+     * The set can hold at most 2^32 - 2 elements, inserting more throws std::length_error. Inserting may move the
+     * nodes, which does not invalidate iterators.
+     *
+     * @tparam key The type of the value of an entry in the set. It must be default constructible and copy assignable.
+     * @tparam compare A binary predicate that defines a strict weak ordering, used to order the elements.\n The expression compare(a,b) shall return true if a is considered to go before b.
+     */
+    template<class key, class compare=std::less<key>>
+    class compact_set {
+    private:
+        using index = uint32_t;
+
+        /* The index of the dummy node, used to mark the end of the container. It is the first node of the vector */
+        static constexpr index nil = 0;
+
+        /* A node in the tree structure. A free node keeps the next free node in left */
+        struct node {
+            key key_value;
+            index left, right, parent;
+        };
+
+        /* All the nodes, including nil and the free ones. It is empty in a moved-from set until a node is added */
+        std::vector<node> nodes;
+
+        /* The root of the tree */
+        index root;
+
+        /* The first free node, or nil */
+        index free_head;
+
+        /* The number of nodes in the tree structure */
+        size_t count;
+
+        /* The seed of the priorities, every set has its own */
+        uint64_t seed;
+
+        /*The comparator, used to compare keys */
+        compare comparator;
+
+        /* Returns the priority of the node, a splitmix64 hash of its index. The priority of nil is 0 */
+        uint64_t priority(index here) const {
+            if (here == nil)
+                return 0;
+            uint64_t z = seed + here * 0x9E3779B97F4A7C15ULL;
+            z = (z ^ (z >> 30u)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27u)) * 0x94D049BB133111EBULL;
+            return (z ^ (z >> 31u)) | 1u;
+        }
+
+        /* Returns a reference to the link that points to the given node: the root or a child index of its parent */
+        index &link_to(index here) {
+            index parent = nodes[here].parent;
+            if (parent == nil)
+                return root;
+            return nodes[parent].left == here ? nodes[parent].left : nodes[parent].right;
+        }
+
+        /* Rotate the node above its parent */
+        void rotate_up(index here) {
+            index parent = nodes[here].parent;
+            link_to(parent) = here;
+            nodes[here].parent = nodes[parent].parent;
+
+            if (nodes[parent].left == here) {
+                nodes[parent].left = nodes[here].right;
+                if (nodes[here].right != nil)
+                    nodes[nodes[here].right].parent = parent;
+                nodes[here].right = parent;
+            } else {
+                nodes[parent].right = nodes[here].left;
+                if (nodes[here].left != nil)
+                    nodes[nodes[here].left].parent = parent;
+                nodes[here].left = parent;
+            }
+            nodes[parent].parent = here;
+        }
+
+        /* Returns a free node holding the given key. Throws std::length_error if every index is taken */
+        index create_node(const key &key_value, index parent) {
+            if (nodes.empty())
+                nodes.push_back({key(), nil, nil, nil});
+            index here = free_head;
+            if (here != nil) {
+                free_head = nodes[here].left;
+                nodes[here] = {key_value, nil, nil, parent};
+            } else {
+                if (nodes.size() >= std::numeric_limits<index>::max())
+                    throw std::length_error("dsl::compact_set: too many elements for 32-bit indices");
+                here = static_cast<index>(nodes.size());
+                nodes.push_back({key_value, nil, nil, parent});
+            }
+            return here;
+        }
+
+        /* This method returns the node with the minimum value in the given subtree */
+        index tree_minimum(index here) const {
+            while (nodes[here].left != nil)
+                here = nodes[here].left;
+            return here;
+        }
+
+        /* This method returns the node with the maximum value in the given subtree */
+        index tree_maximum(index here) const {
+            while (nodes[here].right != nil)
+                here = nodes[here].right;
+            return here;
+        }
+
+        /* Returns the successor of the node. If no such node exists, return nil */
+        index tree_successor(index x) const {
+            if (nodes[x].right != nil)
+                return tree_minimum(nodes[x].right);
+
+            index y = nodes[x].parent;
+            while (y != nil && x == nodes[y].right) {
+                x = y;
+                y = nodes[y].parent;
+            }
+            return y;
+        }
+
+        /* Same as tree_successor but return the node that precedes the given node*/
+        index tree_predecessor(index x) const {
+            if (nodes[x].left != nil)
+                return tree_maximum(nodes[x].left);
+
+            index y = nodes[x].parent;
+            while (y != nil && x == nodes[y].left) {
+                x = y;
+                y = nodes[y].parent;
+            }
+            return y;
+        }
+
+        /* Returns the first node that does not go before the value, or nil */
+        index lower_bound_node(const key &key_value) {
+            index here = root, ans = nil;
+            while (here != nil) {
+                if (comparator(nodes[here].key_value, key_value)) {
+                    here = nodes[here].right;
+                } else {
+                    ans = here;
+                    here = nodes[here].left;
+                }
+            }
+            return ans;
+        }
+
+        /* Returns the first node that goes after the value, or nil */
+        index upper_bound_node(const key &key_value) {
+            index here = root, ans = nil;
+            while (here != nil) {
+                if (comparator(key_value, nodes[here].key_value)) {
+                    ans = here;
+                    here = nodes[here].left;
+                } else {
+                    here = nodes[here].right;
+                }
+            }
+            return ans;
+        }
+
+        /* Leaves the set empty without allocating, after its nodes were moved away. The nil node is added back by
+         * the next insert */
+        void forget_nodes() {
+            nodes.clear();
+            root = nil;
+            free_head = nil;
+            count = 0;
+        }
+
+        /* Seeds the priorities, differently for every set even when built at the same address */
+        void seed_priorities() {
+            seed = detail::fresh_seed(this);
+        }
+
+    public:
+
+        /**
+         * This is the iterator for the set.
+         * Iterating through the set returns the elements in the order defined by the compare predicate
+         */
+        struct iterator {
+            friend class compact_set;
+
+            using iterator_category = std::bidirectional_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = const key;
+            using pointer = const key *;
+            using reference = const key &;
+
+            iterator(index here, compact_set *structure) : h_node(here), h_structure(structure) {
+
+            }
+
+            /** De-references the iterator. */
+            reference operator*() const {
+                return h_structure->nodes[h_node].key_value;
+            }
+
+            /** De-references the iterator. */
+            pointer operator->() {
+                return &h_structure->nodes[h_node].key_value;
+            }
+
+            /** Incrementing this iterator is finding the successor of the element the iterator points at. */
+            iterator &operator++() {
+                h_node = h_structure->tree_successor(h_node);
+                return *this;
+            }
+
+            /** Post-increment, same as pre-increment, but return the value before the increment. */
+            iterator operator++(int) {
+                iterator tmp = *this;
+                h_node = h_structure->tree_successor(h_node);
+                return tmp;
+            }
+
+            /** Decrementing this iterator is finding the predecessor of the element the iterator points at. */
+            iterator &operator--() {
+                if (h_node == nil) { //If its the end iterator, jump to the greatest value in the tree
+                    h_node = h_structure->tree_maximum(h_structure->root);
+                } else {
+                    h_node = h_structure->tree_predecessor(h_node);
+                }
+                return *this;
+            }
+
+            /** Post-decrement, same as pre-decrement, but return the value before the decrement. */
+            iterator operator--(int) {
+                iterator tmp = *this;
+                --*this;
+                return tmp;
+            }
+
+            /** Checks if two iterators are equal. */
+            friend bool operator==(const iterator &a, const iterator &b) { return a.h_node == b.h_node; };
+
+            /** Checks if two iterators are not equal. */
+            friend bool operator!=(const iterator &a, const iterator &b) { return a.h_node != b.h_node; };
+
+        private:
+            /* The position of the iterator in the tree */
+            index h_node;
+
+            compact_set *h_structure;//a reference to the set
+        };
+
+        compact_set() : nodes(1, node{key(), nil, nil, nil}), root(nil), free_head(nil), count(0) {
+            seed_priorities();
+        }
+
+        /** Copy constructor, make a copy of the other set. The nodes are copied as one block. */
+        compact_set(const compact_set &other) = default;
+
+        /** Move constructor, takes the nodes of the other set. The other set is left empty. */
+        compact_set(compact_set &&other) noexcept: nodes(std::move(other.nodes)), root(other.root),
+                                                   free_head(other.free_head), count(other.count), seed(other.seed),
+                                                   comparator(std::move(other.comparator)) {
+            other.forget_nodes();
+        }
+
+        /** Assigns new contents to the set, replacing its current contents.*/
+        compact_set &operator=(const compact_set &other) = default;
+
+        /** Move assignment, takes the nodes of the other set. The other set is left empty. */
+        compact_set &operator=(compact_set &&other) noexcept {
+            if (this != &other) {
+                nodes = std::move(other.nodes);
+                root = other.root;
+                free_head = other.free_head;
+                count = other.count;
+                seed = other.seed;
+                comparator = std::move(other.comparator);
+                other.forget_nodes();
+            }
+            return *this;
+        }
+
+        /** Swaps the content of this set with another set.*/
+        void swap(compact_set &other) {
+            nodes.swap(other.nodes);
+            std::swap(root, other.root);
+            std::swap(free_head, other.free_head);
+            std::swap(count, other.count);
+            std::swap(seed, other.seed);
+            std::swap(comparator, other.comparator);
+        }
+
+        /** Returns an iterator to the first element in the set. */
+        iterator begin() {
+            return iterator(root == nil ? nil : tree_minimum(root), this);
+        }
+
+        /** Returns an iterator that represents the end of the set. */
+        iterator end() {
+            return iterator(nil, this);
+        }
+
+        /** Insert a new entry with the given key value. **/
+        void insert(const key &key_value) {
+            index parent = nil, candidate = nil, here = root;
+            bool go_left = false;
+
+            /* Walk down with one comparison per level, remembering the last node that does not go after the key */
+            while (here != nil) {
+                parent = here;
+                go_left = comparator(key_value, nodes[here].key_value);
+                if (go_left) {
+                    here = nodes[here].left;
+                } else {
+                    candidate = here;
+                    here = nodes[here].right;
+                }
+            }
+
+            if (candidate != nil && !comparator(nodes[candidate].key_value, key_value))
+                return;
+
+            index added = create_node(key_value, parent);
+            if (parent == nil)
+                root = added;
+            else if (go_left)
+                nodes[parent].left = added;
+            else
+                nodes[parent].right = added;
+            count++;
+
+            /* Rotate the new node up while it breaks the heap property of the priorities */
+            while (nodes[added].parent != nil && priority(added) > priority(nodes[added].parent))
+                rotate_up(added);
+        }
+
+        /** Returns an iterator that points to the element with the given key. If no element with the given key is found in the set, return the end iterator. */
+        iterator find(const key &key_value) {
+            index ans = lower_bound_node(key_value);
+            if (ans != nil && !comparator(key_value, nodes[ans].key_value))
+                return iterator(ans, this);
+            return end();
+        }
+
+        /** Returns an iterator to the first element which is not considered to go before the given value. */
+        iterator lower_bound(const key &value) {
+            return iterator(lower_bound_node(value), this);
+        }
+
+        /** Returns an iterator to the first element which is considered to go after the given value. */
+        iterator upper_bound(const key &value) {
+            return iterator(upper_bound_node(value), this);
+        }
+
+        /** Removes an element from the set by iterator. */
+        void erase(iterator to_erase) {
+            index here = to_erase.h_node;
+            if (here == nil)
+                return;
+
+            /* Rotate it down while keeping the heap property, until it becomes a leaf */
+            while (nodes[here].left != nil || nodes[here].right != nil) {
+                index left = nodes[here].left, right = nodes[here].right;
+                rotate_up(priority(left) > priority(right) ? left : right);
+            }
+
+            link_to(here) = nil;
+            nodes[here].key_value = key();
+            nodes[here].left = free_head;
+            free_head = here;
+            count--;
+        }
+
+        /** Returns the number of elements in the set. */
+        size_t size() const {
+            return count;
+        }
+
+        /** Checks if the container is empty. */
+        bool empty() const {
+            return count == 0;
+        }
+
+        /** Removes all the elements from the set. */
+        void clear() {
+            nodes.resize(1);
+            root = nil;
+            free_head = nil;
+            count = 0;
+        }
+    };
+}
+
+#endif //DSL_COMPACT_SET_H
@@ -0,0 +1,445 @@
+//
+// Created by gvisan on 18.10.2026.
+//
+
+#ifndef DSL_CONCURRENT_SET_H
+#define DSL_CONCURRENT_SET_H
+
+#include<atomic> //for atomic
+#include<cstddef> //for size_t
+#include<cstdint> //for uint64_t, uintptr_t
+#include<functional> //for less
+#include<iterator> //for std::bidirectional_iterator_tag
+#include<new> //for placement new
+#include"epoch.h"
+#include"seed.h"
+
+namespace dsl {
+
+    /**
+     * This class is an implementation of a lock-free concurrent ordered set using a skip list.
+     *
+     * All the operations can be called from any number of threads at the same time. find, lower_bound, upper_bound
+     * and iteration never write to shared memory, insert and erase link and unlink nodes with compare-and-swap.
+     * An erased node is deleted with epoch-based reclamation, once no thread can be reading it.
+     *
+     * An iterator keeps its thread in a critical section of the reclamation, so it must stay on the thread that
+     * created it and should not be kept for long. Iterating sees the elements present during the whole iteration,
+     * elements inserted or erased meanwhile may or may not be seen.
+     *
+     * @tparam key The type of the value of an entry in the set. It must be default constructible.
+     * @tparam compare A binary predicate that defines a strict weak ordering, used to order the elements.\n The expression compare(a,b) shall return true if a is considered to go before b.
+     */
+    template<class key, class compare=std::less<key>>
+    class concurrent_set {
+    private:
+
+        /* The maximum number of levels of the skip list */
+        static constexpr int max_level = 32;
+
+        /* A node of the skip list. It is followed in memory by its array of links, one for each level */
+        struct alignas(std::atomic<uintptr_t>) node {
+            const key key_value;
+            const int height;
+
+            /* The inserting thread and the list each hold one reference, the last one to let go retires the node */
+            std::atomic<int> references;
+
+            node(const key &value, int h) : key_value(value), height(h), references(2) {
+
+            }
+
+            /* The link to the next node at the given level. The lowest bit marks this node as erased at that level */
+            std::atomic<uintptr_t> &next(int level) {
+                return reinterpret_cast<std::atomic<uintptr_t> *>(this + 1)[level];
+            }
+        };
+
+        /* The first node, present at every level. Its key is never compared. The end of every level is nullptr */
+        node *head;
+
+        /* The number of elements */
+        std::atomic<size_t> count;
+
+        /*The comparator, used to compare keys */
+        compare comparator;
+
+        static node *pointer(uintptr_t link) {
+            return reinterpret_cast<node *>(link & ~uintptr_t(1));
+        }
+
+        static bool marked(uintptr_t link) {
+            return (link & 1u) != 0;
+        }
+
+        static uintptr_t link_to(node *here, bool mark = false) {
+            return reinterpret_cast<uintptr_t>(here) | uintptr_t(mark);
+        }
+
+        /* Allocate a node with the given number of levels, with all the links empty */
+        static node *create_node(const key &value, int height) {
+            void *memory = ::operator new(sizeof(node) + height * sizeof(std::atomic<uintptr_t>));
+            node *created = new(memory) node(value, height);
+            for (int level = 0; level < height; level++)
+                new(&created->next(level)) std::atomic<uintptr_t>(0);
+            return created;
+        }
+
+        static void destroy_node(void *memory) {
+            node *here = static_cast<node *>(memory);
+            here->~node();
+            ::operator delete(memory);
+        }
+
+        /* Drop one reference to the node, retiring it if it was the last one */
+        static void release(node *here) {
+            if (here->references.fetch_sub(1) == 1)
+                detail::epoch_domain::instance().retire(here, &destroy_node);
+        }
+
+        /* Returns a random number of levels, each level is kept with probability 1/2. The generator is per thread */
+        static int random_level() {
+            thread_local uint64_t seed = detail::fresh_seed(&seed) | 1u;
+            seed ^= seed >> 12u;
+            seed ^= seed << 25u;
+            seed ^= seed >> 27u;
+            uint64_t bits = seed * 0x2545F4914F6CDD1DULL;
+
+            int level = 1;
+            while ((bits & 1u) && level < max_level) {
+                level++;
+                bits >>= 1u;
+            }
+            return level;
+        }
+
+        /* Fill preds and succs with the nodes around the position of the key at every level, unlinking the erased nodes
+         * on the way. If past_equal is set, the nodes equivalent to the key are passed too. Returns the node equivalent
+         * to the key, or nullptr */
+        node *search(const key &key_value, node **preds, node **succs, bool past_equal = false) {
+            retry:
+            node *pred = head;
+            for (int level = max_level - 1; level >= 0; level--) {
+                node *current = pointer(pred->next(level).load());
+                while (current != nullptr) {
+                    uintptr_t successor = current->next(level).load();
+                    if (marked(successor)) { // Unlink the erased node
+                        uintptr_t expected = link_to(current);
+                        if (!pred->next(level).compare_exchange_strong(expected, link_to(pointer(successor))))
+                            goto retry;
+                        current = pointer(successor);
+                        continue;
+                    }
+
+                    if (comparator(current->key_value, key_value) ||
+                        (past_equal && !comparator(key_value, current->key_value))) {
+                        pred = current;
+                        current = pointer(successor);
+                    } else {
+                        break;
+                    }
+                }
+                preds[level] = pred;
+                succs[level] = current;
+            }
+
+            node *ans = succs[0];
+            if (ans != nullptr && !comparator(key_value, ans->key_value))
+                return ans;
+            return nullptr;
+        }
+
+        /* Returns the first node at the lowest level, that is not erased, for which the predicate on its key is false.
+         * The predicate must be true for a prefix of the keys. This does not write to shared memory */
+        template<class predicate>
+        node *first_not(predicate &&goes_before) const {
+            node *pred = head, *current = nullptr;
+            for (int level = max_level - 1; level >= 0; level--) {
+                current = pointer(pred->next(level).load());
+                while (current != nullptr) {
+                    uintptr_t successor = current->next(level).load();
+                    if (marked(successor) || goes_before(current->key_value)) {
+                        if (!marked(successor))
+                            pred = current;
+                        current = pointer(successor);
+                    } else {
+                        break;
+                    }
+                }
+            }
+            return current;
+        }
+
+        /* Returns the last node, that is not erased, for which the predicate on its key is true, or nullptr */
+        template<class predicate>
+        node *last_of(predicate &&goes_before) const {
+            node *pred = head;
+            for (int level = max_level - 1; level >= 0; level--) {
+                node *current = pointer(pred->next(level).load());
+                while (current != nullptr) {
+                    uintptr_t successor = current->next(level).load();
+                    if (marked(successor) || goes_before(current->key_value)) {
+                        if (!marked(successor))
+                            pred = current;
+                        current = pointer(successor);
+                    } else {
+                        break;
+                    }
+                }
+            }
+            return pred == head ? nullptr : pred;
+        }
+
+        /* Returns the next node at the lowest level that is not erased */
+        static node *next_present(node *here) {
+            node *current = pointer(here->next(0).load());
+            while (current != nullptr && marked(current->next(0).load()))
+                current = pointer(current->next(0).load());
+            return current;
+        }
+
+        /* Mark the node as erased and unlink it. Returns false if another thread erased it first. Must be called in a
+         * critical section that started while the node was reachable */
+        bool erase_node(node *victim, node **preds, node **succs) {
+            /* Mark the upper levels, from the top */
+            for (int level = victim->height - 1; level > 0; level--) {
+                uintptr_t current = victim->next(level).load();
+                while (!marked(current) &&
+                       !victim->next(level).compare_exchange_weak(current, current | 1u));
+            }
+
+            /* Marking the lowest level erases the node, only one thread can do it */
+            uintptr_t current = victim->next(0).load();
+            while (true) {
+                if (marked(current))
+                    return false; // Another thread erased it first
+                if (victim->next(0).compare_exchange_strong(current, current | 1u))
+                    break;
+            }
+            count.fetch_sub(1);
+
+            /* Unlink it from all the levels */
+            search(victim->key_value, preds, succs, true);
+            release(victim);
+            return true;
+        }
+
+    public:
+
+        /**
+         * This is the iterator for the set.
+         * Iterating through the set returns the elements in the order defined by the compare predicate.
+         */
+        struct iterator {
+            friend class concurrent_set;
+
+            using iterator_category = std::bidirectional_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = const key;
+            using pointer = const key *;
+            using reference = const key &;
+
+            iterator(node *here, const concurrent_set *structure) : h_node(here), h_structure(structure) {
+
+            }
+
+            /** De-references the iterator. */
+            reference operator*() const {
+                return h_node->key_value;
+            }
+
+            /** De-references the iterator. */
+            pointer operator->() {
+                return &h_node->key_value;
+            }
+
+            /** Incrementing this iterator moves to the next element at the lowest level, skipping the erased ones. */
+            iterator &operator++() {
+                h_node = next_present(h_node);
+                return *this;
+            }
+
+            /** Post-increment, same as pre-increment, but return the value before the increment. */
+            iterator operator++(int) {
+                iterator tmp = *this;
+                h_node = next_present(h_node);
+                return tmp;
+            }
+
+            /** Decrementing this iterator searches the greatest element that goes before the current one. */
+            iterator &operator--() {
+                if (h_node == nullptr) { //If its the end iterator, jump to the greatest value in the set
+                    h_node = h_structure->last_of([](const key &) { return true; });
+                } else {
+                    const key &current = h_node->key_value;
+                    h_node = h_structure->last_of([this, &current](const key &value) {
+                        return h_structure->comparator(value, current);
+                    });
+                }
+                return *this;
+            }
+
+            /** Post-decrement, same as pre-decrement, but return the value before the decrement. */
+            iterator operator--(int) {
+                iterator tmp = *this;
+                --*this;
+                return tmp;
+            }
+
+            /** Checks if two iterators are equal. */
+            friend bool operator==(const iterator &a, const iterator &b) { return a.h_node == b.h_node; };
+
+            /** Checks if two iterators are not equal. */
+            friend bool operator!=(const iterator &a, const iterator &b) { return a.h_node != b.h_node; };
+
+        private:
+            /* Keeps the nodes seen by the iterator from being deleted */
+            detail::epoch_guard h_guard;
+
+            /* The position of the iterator, nullptr for the end iterator */
+            node *h_node;
+
+            const concurrent_set *h_structure;//a reference to the set
+        };
+
+        concurrent_set() : head(create_node(key(), max_level)), count(0) {
+
+        }
+
+        concurrent_set(const concurrent_set &) = delete;
+
+        concurrent_set &operator=(const concurrent_set &) = delete;
+
+        /** Destroys the set. No other thread may use it at this point. */
+        ~concurrent_set() {
+            node *here = head;
+            while (here != nullptr) {
+                node *next = pointer(here->next(0).load());
+                destroy_node(here);
+                here = next;
+            }
+        }
+
+        /** Returns an iterator to the first element in the set. */
+        iterator begin() const {
+            detail::epoch_guard guard;
+            return iterator(next_present(head), this);
+        }
+
+        /** Returns an iterator that represents the end of the set. */
+        iterator end() const {
+            return iterator(nullptr, this);
+        }
+
+        /** Insert a new entry with the given key value. Returns false if the key was already in the set. **/
+        bool insert(const key &key_value) {
+            detail::epoch_guard guard;
+            node *preds[max_level], *succs[max_level];
+            int height = random_level();
+            node *added = nullptr;
+
+            /* Link the node at the lowest level, this makes it part of the set */
+            while (true) {
+                if (search(key_value, preds, succs) != nullptr) {
+                    if (added != nullptr)
+                        destroy_node(added); // It was never visible to other threads
+                    return false;
+                }
+
+                if (added == nullptr)
+                    added = create_node(key_value, height);
+                for (int level = 0; level < height; level++)
+                    added->next(level).store(link_to(succs[level]));
+
+                uintptr_t expected = link_to(succs[0]);
+                if (preds[0]->next(0).compare_exchange_strong(expected, link_to(added)))
+                    break;
+            }
+            count.fetch_add(1);
+
+            /* Link it at the upper levels, unless it is erased meanwhile */
+            for (int level = 1; level < height; level++) {
+                while (true) {
+                    uintptr_t current = added->next(level).load();
+                    if (marked(current))
+                        goto linked;
+
+                    if (pointer(current) != succs[level] &&
+                        !added->next(level).compare_exchange_strong(current, link_to(succs[level])))
+                        continue;
+
+                    uintptr_t expected = link_to(succs[level]);
+                    if (preds[level]->next(level).compare_exchange_strong(expected, link_to(added)))
+                        break;
+
+                    if (search(key_value, preds, succs) != added)
+                        goto linked; // It was erased
+                }
+            }
+
+            linked:
+            /* If an erase started, this thread may have linked levels after the eraser unlinked the node, so unlink them */
+            if (marked(added->next(height - 1).load()))
+                search(key_value, preds, succs, true);
+            release(added);
+            return true;
+        }
+
+        /** Returns an iterator that points to the element with the given key. If no element with the given key is found in the set, return the end iterator. */
+        iterator find(const key &key_value) const {
+            iterator ans = lower_bound(key_value);
+            if (ans.h_node != nullptr && comparator(key_value, ans.h_node->key_value))
+                return end();
+            return ans;
+        }
+
+        /** Returns an iterator to the first element which is not considered to go before the given value. */
+        iterator lower_bound(const key &value) const {
+            detail::epoch_guard guard;
+            return iterator(first_not([this, &value](const key &here) { return comparator(here, value); }), this);
+        }
+
+        /** Returns an iterator to the first element which is considered to go after the given value. */
+        iterator upper_bound(const key &value) const {
+            detail::epoch_guard guard;
+            return iterator(first_not([this, &value](const key &here) { return !comparator(value, here); }), this);
+        }
+
+        /** Removes the element with the given key. Returns false if it was not in the set. */
+        bool erase(const key &key_value) {
+            detail::epoch_guard guard;
+            node *preds[max_level], *succs[max_level];
+            node *victim = search(key_value, preds, succs);
+            return victim != nullptr && erase_node(victim, preds, succs);
+        }
+
+        /**
+         * Removes the element the iterator points to, and not another element with the same key inserted after it was
+         * erased. Returns false if the element was already erased, or if the iterator is the end iterator.
+         */
+        bool erase(iterator to_erase) {
+            if (to_erase.h_node == nullptr)
+                return false;
+            node *preds[max_level], *succs[max_level];
+            return erase_node(to_erase.h_node, preds, succs);
+        }
+
+        /** Returns the number of elements in the set. It is exact only when no other thread modifies the set. */
+        size_t size() const {
+            return count.load();
+        }
+
+        /** Checks if the container is empty. */
+        bool empty() const {
+            return count.load() == 0;
+        }
+
+        /** Removes all the elements from the set, one by one. */
+        void clear() {
+            for (iterator here = begin(); here != end(); ++here)
+                erase(here);
+        }
+    };
+}
+
+#endif //DSL_CONCURRENT_SET_H
@@ -0,0 +1,187 @@
+//
+// Created by gvisan on 18.10.2026.
+//
+
+#ifndef DSL_EPOCH_H
+#define DSL_EPOCH_H
+
+#include<atomic> //for atomic
+#include<cstdint> //for uint64_t
+#include<vector>
+
+namespace dsl {
+
+    namespace detail {
+
+        /*
+         * Epoch-based reclamation, shared by all the lock-free containers of the process.
+         *
+         * A thread announces the global epoch while it reads shared nodes. A node that was unlinked is retired in the
+         * current epoch, and deleted once the global epoch moved two steps further: by then, every thread that could
+         * have seen it has left its critical section.
+         */
+        class epoch_domain {
+        private:
+            /* A node waiting to be deleted */
+            struct retired {
+                void *pointer;
+
+                void (*deleter)(void *);
+            };
+
+            /* The nodes retired by a thread in one epoch */
+            struct limbo_list {
+                uint64_t epoch = 0;
+                std::vector<retired> nodes;
+
+                void free_all() {
+                    for (retired &here : nodes)
+                        here.deleter(here.pointer);
+                    nodes.clear();
+                }
+            };
+
+            /* The state of one thread. Records are reused by new threads and never freed before the domain */
+            struct alignas(64) record {
+                /* The epoch announced by the thread, or 0 outside of critical sections */
+                std::atomic<uint64_t> epoch{0};
+
+                /* Whether a thread owns this record */
+                std::atomic<bool> in_use{true};
+
+                record *next = nullptr;
+
+                /* The number of nested critical sections */
+                unsigned nesting = 0;
+
+                /* The number of nodes retired since the last attempt to advance the epoch */
+                unsigned retired_since_advance = 0;
+
+                limbo_list limbo[3];
+            };
+
+            /* Releases the record of a thread when the thread exits */
+            struct thread_handle {
+                record *here;
+
+                explicit thread_handle(epoch_domain &domain) : here(domain.acquire_record()) {
+
+                }
+
+                ~thread_handle() {
+                    here->in_use.store(false);
+                }
+            };
+
+            /* The global epoch, it starts at 1 since 0 means not in a critical section */
+            std::atomic<uint64_t> global{1};
+
+            /* All the records ever created */
+            std::atomic<record *> records{nullptr};
+
+            /* Try to move the global epoch forward, which is possible if every active thread has seen it */
+            void try_advance() {
+                uint64_t current = global.load();
+                for (record *here = records.load(); here != nullptr; here = here->next) {
+                    uint64_t announced = here->epoch.load();
+                    if (announced != 0 && announced != current)
+                        return;
+                }
+                global.compare_exchange_strong(current, current + 1);
+            }
+
+            record *acquire_record() {
+                for (record *here = records.load(); here != nullptr; here = here->next) {
+                    bool expected = false;
+                    if (here->in_use.compare_exchange_strong(expected, true))
+                        return here;
+                }
+
+                record *added = new record();
+                added->next = records.load();
+                while (!records.compare_exchange_weak(added->next, added));
+                return added;
+            }
+
+            /* Returns the record of the calling thread */
+            record *local() {
+                thread_local thread_handle handle(*this);
+                return handle.here;
+            }
+
+        public:
+            /* Nodes are retired in batches of this size before trying to advance the epoch */
+            static constexpr unsigned advance_period = 64;
+
+            /* Returns the domain of the process */
+            static epoch_domain &instance() {
+                static epoch_domain domain;
+                return domain;
+            }
+
+            /* Enter a critical section, the nodes reachable from now on are not deleted until it is left */
+            void enter() {
+                record *here = local();
+                if (here->nesting++ == 0)
+                    here->epoch.store(global.load());
+            }
+
+            /* Leave a critical section */
+            void leave() {
+                record *here = local();
+                if (--here->nesting == 0)
+                    here->epoch.store(0);
+            }
+
+            /* Delete the node with the given function once no thread can read it anymore. Must be called in a critical section */
+            void retire(void *pointer, void (*deleter)(void *)) {
+                record *here = local();
+                uint64_t current = global.load();
+
+                /* The list of this slot holds nodes retired at least three epochs ago, they can be deleted */
+                limbo_list &list = here->limbo[current % 3];
+                if (list.epoch != current) {
+                    list.free_all();
+                    list.epoch = current;
+                }
+                list.nodes.push_back({pointer, deleter});
+
+                if (++here->retired_since_advance == advance_period) {
+                    here->retired_since_advance = 0;
+                    try_advance();
+                }
+            }
+
+            ~epoch_domain() {
+                record *here = records.load();
+                while (here != nullptr) {
+                    record *next = here->next;
+                    for (limbo_list &list : here->limbo)
+                        list.free_all();
+                    delete here;
+                    here = next;
+                }
+            }
+        };
+
+        /* Keeps the calling thread in a critical section of the epoch domain while it exists */
+        class epoch_guard {
+        public:
+            epoch_guard() {
+                epoch_domain::instance().enter();
+            }
+
+            epoch_guard(const epoch_guard &) {
+                epoch_domain::instance().enter();
+            }
+
+            epoch_guard &operator=(const epoch_guard &) = default;
+
+            ~epoch_guard() {
+                epoch_domain::instance().leave();
+            }
+        };
+    }
+}
+
+#endif //DSL_EPOCH_H
@@ -0,0 +1,339 @@
+//
+// Created by gvisan on 18.10.2026.
+//
+
+#ifndef DSL_FLAT_SET_H
+#define DSL_FLAT_SET_H
+
+#include<algorithm> //for lower_bound, upper_bound, move_backward
+#include<cstddef> //for size_t
+#include<functional> //for less
+#include<iterator> //for std::bidirectional_iterator_tag
+#include<new> //for placement new
+#include<type_traits> //for is_arithmetic, is_nothrow_move_constructible
+#include<utility> //for swap, move
+
+namespace dsl {
+
+    /**
+     * This class is an implementation of an ordered set using a sorted array, for sets that hold few elements.
+     *
+     * It has the same interface as dsl::set. Up to inline_capacity keys are stored inside the set object itself, so
+     * a small set never allocates memory. Past that, the keys move to an array on the heap that doubles in size.
+     * Inserting and erasing move the keys that follow the position, which is cheap for small sets but O(n).
+     *
+     * Inserting and erasing invalidate the iterators.
+     *
+     * @tparam key The type of the value of an entry in the set. It must be move constructible and move assignable.
+     * @tparam compare A binary predicate that defines a strict weak ordering, used to order the elements.\n The expression compare(a,b) shall return true if a is considered to go before b.
+     * @tparam inline_capacity The number of keys stored without allocating memory.
+     */
+    template<class key, class compare=std::less<key>, size_t inline_capacity = 32>
+    class flat_set {
+    private:
+
+        /* The size of the inline storage, which can not be empty */
+        static constexpr size_t inline_slots = inline_capacity > 0 ? inline_capacity : 1;
+
+        /* The maximum number of keys searched with a branchless scan instead of a binary search */
+        static constexpr size_t linear_limit = 8;
+
+        /* Whether small sets are searched with a branchless scan instead of a binary search */
+        static constexpr bool linear_search = std::is_arithmetic<key>::value &&
+                                              (std::is_same<compare, std::less<key>>::value ||
+                                               std::is_same<compare, std::less<>>::value);
+
+        /* The storage for the keys while they fit in the set object */
+        alignas(key) unsigned char inline_storage[inline_slots * sizeof(key)];
+
+        /* The keys, in order. It points to inline_storage or to an array on the heap */
+        key *keys;
+
+        /* The number of keys in the set */
+        size_t count;
+
+        /* The number of keys that fit in the current storage */
+        size_t capacity;
+
+        /*The comparator, used to compare keys */
+        compare comparator;
+
+        key *inline_keys() {
+            return reinterpret_cast<key *>(inline_storage);
+        }
+
+        bool is_inline() const {
+            return keys == reinterpret_cast<const key *>(inline_storage);
+        }
+
+        /* Returns the number of keys that go before the value */
+        size_t count_before(const key &value) const {
+            if constexpr (linear_search) {
+                if (count <= linear_limit) {
+                    size_t ans = 0;
+                    for (size_t i = 0; i < count; i++)
+                        ans += keys[i] < value;
+                    return ans;
+                }
+            }
+            return std::lower_bound(keys, keys + count, value, comparator) - keys;
+        }
+
+        /* Returns the number of keys that do not go after the value */
+        size_t count_not_after(const key &value) const {
+            if constexpr (linear_search) {
+                if (count <= linear_limit) {
+                    size_t ans = 0;
+                    for (size_t i = 0; i < count; i++)
+                        ans += !(value < keys[i]);
+                    return ans;
+                }
+            }
+            return std::upper_bound(keys, keys + count, value, comparator) - keys;
+        }
+
+        /* Move the keys to a heap array of the given capacity, which must hold them all */
+        void reallocate(size_t new_capacity) {
+            key *moved = static_cast<key *>(::operator new(new_capacity * sizeof(key)));
+            for (size_t i = 0; i < count; i++) {
+                new(moved + i) key(std::move(keys[i]));
+                keys[i].~key();
+            }
+            release_storage();
+            keys = moved;
+            capacity = new_capacity;
+        }
+
+        /* Free the heap array, if there is one. The keys must be already destroyed or moved */
+        void release_storage() {
+            if (!is_inline())
+                ::operator delete(keys);
+            keys = inline_keys();
+            capacity = inline_slots;
+        }
+
+        /* Destroy the keys and go back to the inline storage */
+        void destroy() {
+            for (size_t i = 0; i < count; i++)
+                keys[i].~key();
+            count = 0;
+            release_storage();
+        }
+
+        /* Move the content of the other set into this set, which must be empty. The other set is left empty */
+        void steal(flat_set &other) {
+            if (other.is_inline()) {
+                for (size_t i = 0; i < other.count; i++) {
+                    new(keys + i) key(std::move(other.keys[i]));
+                    other.keys[i].~key();
+                }
+            } else {
+                keys = other.keys;
+                capacity = other.capacity;
+                other.keys = other.inline_keys();
+                other.capacity = inline_slots;
+            }
+            count = other.count;
+            other.count = 0;
+        }
+
+    public:
+
+        /**
+         * This is the iterator for the set.
+         * Iterating through the set returns the elements in the order defined by the compare predicate
+         */
+        struct iterator {
+            friend class flat_set;
+
+            using iterator_category = std::bidirectional_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = const key;
+            using pointer = const key *;
+            using reference = const key &;
+
+            explicit iterator(const key *here) : h_node(here) {
+
+            }
+
+            /** De-references the iterator. */
+            reference operator*() const {
+                return *h_node;
+            }
+
+            /** De-references the iterator. */
+            pointer operator->() {
+                return h_node;
+            }
+
+            /** Incrementing this iterator moves it to the next key in the array. */
+            iterator &operator++() {
+                ++h_node;
+                return *this;
+            }
+
+            /** Post-increment, same as pre-increment, but return the value before the increment. */
+            iterator operator++(int) {
+                iterator tmp = *this;
+                ++h_node;
+                return tmp;
+            }
+
+            /** Decrementing this iterator moves it to the previous key in the array. */
+            iterator &operator--() {
+                --h_node;
+                return *this;
+            }
+
+            /** Post-decrement, same as pre-decrement, but return the value before the decrement. */
+            iterator operator--(int) {
+                iterator tmp = *this;
+                --h_node;
+                return tmp;
+            }
+
+            /** Checks if two iterators are equal. */
+            friend bool operator==(const iterator &a, const iterator &b) { return a.h_node == b.h_node; };
+
+            /** Checks if two iterators are not equal. */
+            friend bool operator!=(const iterator &a, const iterator &b) { return a.h_node != b.h_node; };
+
+        private:
+            /* The position of the iterator in the array */
+            const key *h_node;
+        };
+
+        flat_set() : keys(inline_keys()), count(0), capacity(inline_slots) {
+
+        }
+
+        /** Copy constructor, make a copy of the other set. If copying a key throws, the keys copied so far are destroyed. */
+        flat_set(const flat_set &other) : keys(inline_keys()), count(0), capacity(inline_slots),
+                                          comparator(other.comparator) {
+            if (other.count > capacity)
+                reallocate(other.count);
+            try {
+                for (; count < other.count; count++)
+                    new(keys + count) key(other.keys[count]);
+            } catch (...) {
+                /* The destructor is not run for a constructor that throws */
+                destroy();
+                throw;
+            }
+        }
+
+        /** Move constructor, takes the heap array of the other set or moves its inline keys. The other set is left empty. */
+        flat_set(flat_set &&other) noexcept(std::is_nothrow_move_constructible<key>::value) :
+                keys(inline_keys()), count(0), capacity(inline_slots), comparator(std::move(other.comparator)) {
+            steal(other);
+        }
+
+        /** Assigns new contents to the set, replacing its current contents.*/
+        flat_set &operator=(const flat_set &other) {
+            if (this != &other) {
+                flat_set copy(other);
+                destroy();
+                steal(copy);
+                comparator = other.comparator;
+            }
+            return *this;
+        }
+
+        /** Move assignment, takes the heap array of the other set or moves its inline keys. The other set is left empty. */
+        flat_set &operator=(flat_set &&other) noexcept(std::is_nothrow_move_constructible<key>::value) {
+            if (this != &other) {
+                destroy();
+                steal(other);
+                comparator = std::move(other.comparator);
+            }
+            return *this;
+        }
+
+        /** Swaps the content of this set with another set. Keys stored inline are moved. */
+        void swap(flat_set &other) {
+            flat_set tmp;
+            tmp.steal(*this);
+            steal(other);
+            other.steal(tmp);
+            std::swap(comparator, other.comparator);
+        }
+
+        /** Destroys the set object. */
+        ~flat_set() {
+            destroy();
+        }
+
+        /** Returns an iterator to the first element in the set. */
+        iterator begin() const {
+            return iterator(keys);
+        }
+
+        /** Returns an iterator that represents the end of the set. */
+        iterator end() const {
+            return iterator(keys + count);
+        }
+
+        /** Insert a new entry with the given key value. **/
+        void insert(const key &key_value) {
+            size_t position = count_before(key_value);
+            if (position < count && !comparator(key_value, keys[position]))
+                return;
+
+            if (count == capacity)
+                reallocate(2 * capacity);
+
+            if (position == count) {
+                new(keys + count) key(key_value);
+            } else { // Shift the keys after the position by one, the value is not one of them since it is not in the set
+                new(keys + count) key(std::move(keys[count - 1]));
+                std::move_backward(keys + position, keys + count - 1, keys + count);
+                keys[position] = key_value;
+            }
+            count++;
+        }
+
+        /** Returns an iterator that points to the element with the given key. If no element with the given key is found in the set, return the end iterator. */
+        iterator find(const key &key_value) const {
+            size_t position = count_before(key_value);
+            if (position < count && !comparator(key_value, keys[position]))
+                return iterator(keys + position);
+            return end();
+        }
+
+        /** Returns an iterator to the first element which is not considered to go before the given value. */
+        iterator lower_bound(const key &value) const {
+            return iterator(keys + count_before(value));
+        }
+
+        /** Returns an iterator to the first element which is considered to go after the given value. */
+        iterator upper_bound(const key &value) const {
+            return iterator(keys + count_not_after(value));
+        }
+
+        /** Removes an element from the set by iterator. */
+        void erase(iterator to_erase) {
+            if (to_erase.h_node == keys + count)
+                return;
+            key *position = keys + (to_erase.h_node - keys);
+            std::move(position + 1, keys + count, position);
+            keys[--count].~key();
+        }
+
+        /** Returns the number of elements in the set. */
+        size_t size() const {
+            return count;
+        }
+
+        /** Checks if the container is empty. */
+        bool empty() const {
+            return count == 0;
+        }
+
+        /** Removes all the elements from the set, releasing the heap array. */
+        void clear() {
+            destroy();
+        }
+    };
+}
+
+#endif //DSL_FLAT_SET_H
@@ -0,0 +1,340 @@
+//
+// Created by gvisan on 18.10.2026.
+//
+
+#ifndef DSL_FROZEN_SET_H
+#define DSL_FROZEN_SET_H
+
+#include<cstddef> //for size_t
+#include<functional> //for less
+#include<iterator> //for std::bidirectional_iterator_tag
+#include<new> //for align_val_t
+#include<type_traits> //for is_base_of
+#include<utility> //for swap
+#include<vector>
+#include"set.h" //for building from a dsl::set
+
+namespace dsl {
+
+    /**
+     * This class is an implementation of a read-only ordered set, stored in a single array in Eytzinger order.
+     *
+     * The keys are laid out like an implicit binary search tree in breadth-first order: the sons of the key at position
+     * k are at 2k and 2k+1. A search walks down that tree without branching on the result of the comparisons, and
+     * prefetches the cache line that holds the keys a few levels below. The array is aligned to a cache line, so
+     * these keys are always in one line. For sets that are built once and then only searched, this is much faster
+     * than following the pointers of a dsl::set.
+     *
+     * The set can not be modified after it is built.
+     *
+     * @tparam key The type of the value of an entry in the set. It must be copy constructible.
+     * @tparam compare A binary predicate that defines a strict weak ordering, used to order the elements.\n The expression compare(a,b) shall return true if a is considered to go before b.
+     */
+    template<class key, class compare=std::less<key>>
+    class frozen_set {
+    private:
+        static constexpr size_t cache_line = 64;
+
+        /* The number of keys that fit in a cache line. The keys below position k, log2(line_keys) levels down, start at k * line_keys */
+        static constexpr size_t line_keys = sizeof(key) < cache_line ? cache_line / sizeof(key) : 1;
+
+        /* An allocator that aligns the array to a cache line */
+        template<class type>
+        struct aligned_allocator {
+            using value_type = type;
+
+            aligned_allocator() = default;
+
+            template<class other>
+            aligned_allocator(const aligned_allocator<other> &) {
+
+            }
+
+            type *allocate(size_t n) {
+                return static_cast<type *>(::operator new(n * sizeof(type), std::align_val_t(cache_line)));
+            }
+
+            void deallocate(type *p, size_t) {
+                ::operator delete(p, std::align_val_t(cache_line));
+            }
+
+            friend bool operator==(const aligned_allocator &, const aligned_allocator &) { return true; }
+
+            friend bool operator!=(const aligned_allocator &, const aligned_allocator &) { return false; }
+        };
+
+        /* The keys in Eytzinger order, starting at position 1. Position 0 holds a copy of the smallest key and is never searched */
+        std::vector<key, aligned_allocator<key>> keys;
+
+        /* The number of keys in the set */
+        size_t count;
+
+        /*The comparator, used to compare keys */
+        compare comparator;
+
+        /* Climbs from the position while it is a right son, then once more. It is the position of the first ancestor whose left subtree holds k */
+        static size_t climb(size_t k) {
+#if defined(__GNUC__)
+            return k >> (__builtin_ctzll(~static_cast<unsigned long long>(k)) + 1);
+#else
+            while (k & 1u)
+                k >>= 1u;
+            return k >> 1u;
+#endif
+        }
+
+        /* Returns the position of the minimum key in the subtree at k */
+        size_t tree_minimum(size_t k) const {
+            while (2 * k <= count)
+                k = 2 * k;
+            return k;
+        }
+
+        /* Returns the position of the maximum key in the subtree at k */
+        size_t tree_maximum(size_t k) const {
+            while (2 * k + 1 <= count)
+                k = 2 * k + 1;
+            return k;
+        }
+
+        /* Returns the position of the key that follows the key at k, or 0 */
+        size_t tree_successor(size_t k) const {
+            if (2 * k + 1 <= count)
+                return tree_minimum(2 * k + 1);
+            return climb(k);
+        }
+
+        /* Returns the position of the key that precedes the key at k, or 0 */
+        size_t tree_predecessor(size_t k) const {
+            if (2 * k <= count)
+                return tree_maximum(2 * k);
+            while (k > 1 && !(k & 1u)) //climb while it is a left son
+                k >>= 1u;
+            return k >> 1u;
+        }
+
+        /* Hint the processor to load the keys log2(line_keys) levels below k */
+        void prefetch(size_t k) const {
+#if defined(__GNUC__)
+            size_t ahead = k * line_keys;
+            __builtin_prefetch(keys.data() + (ahead <= count ? ahead : 0));
+#else
+            (void) k;
+#endif
+        }
+
+        /*
+         * Walk down from the root without branches, going right when goes_right holds for the key.
+         * The path ends below a leaf, and the answer is the last node where the walk went left.
+         */
+        template<class predicate>
+        size_t search(predicate goes_right) const {
+            size_t k = 1;
+            while (k <= count) {
+                prefetch(k);
+                k = 2 * k + static_cast<size_t>(goes_right(keys[k]));
+            }
+            return climb(k);
+        }
+
+        /* Fill the array from n sorted keys, visiting the positions in order */
+        template<class Iter>
+        void fill(Iter first, size_t n) {
+            count = n;
+            keys.clear();
+            if (n == 0)
+                return;
+
+            keys.assign(n + 1, *first);
+            for (size_t k = tree_minimum(1); k != 0; k = tree_successor(k), ++first)
+                keys[k] = *first;
+        }
+
+        /* Returns the number of distinct keys in a sorted range */
+        template<class Iter>
+        size_t count_unique(Iter first, Iter last) const {
+            if (first == last)
+                return 0;
+            size_t n = 1;
+            for (Iter previous = first++; first != last; previous = first++)
+                n += static_cast<size_t>(comparator(*previous, *first));
+            return n;
+        }
+
+        /* Fill the array from a sorted range holding n distinct keys, keeping the first of the equivalent keys */
+        template<class Iter>
+        void fill_unique(Iter first, size_t n) {
+            count = n;
+            keys.clear();
+            if (n == 0)
+                return;
+
+            keys.assign(n + 1, *first);
+            size_t previous = 0;
+            for (size_t k = tree_minimum(1); k != 0; previous = k, k = tree_successor(k)) {
+                if (previous != 0) {
+                    do
+                        ++first;
+                    while (!comparator(keys[previous], *first));
+                }
+                keys[k] = *first;
+            }
+        }
+
+    public:
+
+        /**
+         * This is the iterator for the set.
+         * Iterating through the set returns the elements in the order defined by the compare predicate
+         */
+        struct iterator {
+            friend class frozen_set;
+
+            using iterator_category = std::bidirectional_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = const key;
+            using pointer = const key *;
+            using reference = const key &;
+
+            iterator(size_t here, const frozen_set *structure) : h_node(here), h_structure(structure) {
+
+            }
+
+            /** De-references the iterator. */
+            reference operator*() const {
+                return h_structure->keys[h_node];
+            }
+
+            /** De-references the iterator. */
+            pointer operator->() {
+                return &h_structure->keys[h_node];
+            }
+
+            /** Incrementing this iterator is finding the successor of the element the iterator points at. */
+            iterator &operator++() {
+                h_node = h_structure->tree_successor(h_node);
+                return *this;
+            }
+
+            /** Post-increment, same as pre-increment, but return the value before the increment. */
+            iterator operator++(int) {
+                iterator tmp = *this;
+                ++*this;
+                return tmp;
+            }
+
+            /** Decrementing this iterator is finding the predecessor of the element the iterator points at. */
+            iterator &operator--() {
+                if (h_node == 0) { //If its the end iterator, jump to the greatest value in the tree
+                    h_node = h_structure->tree_maximum(1);
+                } else {
+                    h_node = h_structure->tree_predecessor(h_node);
+                }
+                return *this;
+            }
+
+            /** Post-decrement, same as pre-decrement, but return the value before the decrement. */
+            iterator operator--(int) {
+                iterator tmp = *this;
+                --*this;
+                return tmp;
+            }
+
+            /** Checks if two iterators are equal. */
+            friend bool operator==(const iterator &a, const iterator &b) { return a.h_node == b.h_node; };
+
+            /** Checks if two iterators are not equal. */
+            friend bool operator!=(const iterator &a, const iterator &b) { return a.h_node != b.h_node; };
+
+        private:
+            /* The position of the iterator in the array, 0 for the end iterator */
+            size_t h_node;
+
+            const frozen_set *h_structure;//a reference to the set
+        };
+
+        frozen_set() : count(0) {
+
+        }
+
+        /**
+         * Builds the set from a range sorted by the compare predicate, in linear time. Duplicate keys are kept once.
+         * A range of forward iterators is read twice, to count the keys and to place them, without a copy. A range of
+         * input iterators can only be read once, so it is copied first.
+         * @param sorted_first The first element of the range.
+         * @param sorted_last The element after the last element of the range.
+         */
+        template<class Iter, class = typename std::iterator_traits<Iter>::iterator_category>
+        frozen_set(Iter sorted_first, Iter sorted_last) {
+            using category = typename std::iterator_traits<Iter>::iterator_category;
+            if constexpr (std::is_base_of<std::forward_iterator_tag, category>::value) {
+                fill_unique(sorted_first, count_unique(sorted_first, sorted_last));
+            } else {
+                std::vector<key> sorted;
+                for (; sorted_first != sorted_last; ++sorted_first)
+                    if (sorted.empty() || comparator(sorted.back(), *sorted_first))
+                        sorted.push_back(*sorted_first);
+                fill(sorted.begin(), sorted.size());
+            }
+        }
+
+        /** Builds the set from the elements of a dsl::set, in linear time. */
+        template<class augmentation, class statistics_policy>
+        explicit frozen_set(set<key, compare, augmentation, statistics_policy> &source) {
+            fill(source.begin(), source.size());
+        }
+
+        /** Assigns new contents to the set, replacing its current contents.*/
+        frozen_set &operator=(frozen_set other) {
+            swap(other);
+            return *this;
+        }
+
+        /** Swaps the content of this set with another set.*/
+        void swap(frozen_set &other) {
+            keys.swap(other.keys);
+            std::swap(count, other.count);
+            std::swap(comparator, other.comparator);
+        }
+
+        /** Returns an iterator to the first element in the set. */
+        iterator begin() const {
+            return iterator(count == 0 ? 0 : tree_minimum(1), this);
+        }
+
+        /** Returns an iterator that represents the end of the set. */
+        iterator end() const {
+            return iterator(0, this);
+        }
+
+        /** Returns an iterator that points to the element with the given key. If no element with the given key is found in the set, return the end iterator. */
+        iterator find(const key &key_value) const {
+            iterator ans = lower_bound(key_value);
+            if (ans.h_node != 0 && comparator(key_value, keys[ans.h_node]))
+                return end();
+            return ans;
+        }
+
+        /** Returns an iterator to the first element which is not considered to go before the given value. */
+        iterator lower_bound(const key &value) const {
+            return iterator(search([&](const key &here) { return comparator(here, value); }), this);
+        }
+
+        /** Returns an iterator to the first element which is considered to go after the given value. */
+        iterator upper_bound(const key &value) const {
+            return iterator(search([&](const key &here) { return !comparator(value, here); }), this);
+        }
+
+        /** Returns the number of elements in the set. */
+        size_t size() const {
+            return count;
+        }
+
+        /** Checks if the container is empty. */
+        bool empty() const {
+            return count == 0;
+        }
+    };
+}
+
+#endif //DSL_FROZEN_SET_H
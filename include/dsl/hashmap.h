@@ -9,6 +9,8 @@
 #include<functional>
 #include<iterator>
 #include<cstddef>
+#include<utility>
+#include"statistics.h"
 
 namespace dsl {
 
@@ -20,9 +22,11 @@ namespace dsl {
      * @tparam value The type of the mapped value of an entry.
      * @tparam hash A unary function object, used to retrieve the hash code of a key to order elements into buckets.
      * @tparam equal A binary predicate, used to compare two keys for equality.
+     * @tparam statistics_policy dsl::no_statistics, or dsl::collect_statistics to count the probes of the lookups.
      */
-    template<class key, class value, class hash=std::hash<key>, class equal=std::equal_to<key>>
-    class hashmap {
+    template<class key, class value, class hash=std::hash<key>, class equal=std::equal_to<key>,
+            class statistics_policy=no_statistics>
+    class hashmap : private statistics_policy::template storage<detail::hashmap_counters> {
     private:
 
         /* The buckets */
@@ -53,6 +57,24 @@ namespace dsl {
 
         };
 
+        /* Count a lookup that compared the given number of keys */
+        void count_probes(size_t probes) {
+            if constexpr (statistics_policy::enabled) {
+                this->stats.lookups++;
+                this->stats.probes += probes;
+            }
+        }
+
+        /* Move the elements to the given number of buckets */
+        void rehash(size_t bucket_count) {
+            std::vector<std::vector<std::pair<key, value>>> moved(bucket_count);
+            for (auto &bucket : buckets)
+                for (auto &element : bucket)
+                    moved[hasher(element.first) % bucket_count].push_back(std::move(element));
+            buckets.swap(moved);
+            num_buckets = bucket_count;
+        }
+
     public:
         /** This is the iterator for the hashmap.
         Iterating through the map returns the elements in a seemingly random order. **/
@@ -128,6 +150,45 @@ namespace dsl {
             node h_node;
         };
 
+        /** A sequence of consecutive buckets of the map, that can be traversed independently of the others. */
+        struct range {
+            friend class hashmap;
+
+            /** Finds the first element of the range, by iterating through its buckets until a non-empty bucket is found. */
+            iterator begin() const {
+                for (auto iter = first; iter != last; iter++) {
+                    if (iter->size() != 0) {
+                        return iterator({iter, 0, last});
+                    }
+                }
+                return end();
+            }
+
+            /** Returns an iterator past the last element of the range. */
+            iterator end() const {
+                return iterator({last, 0, last});
+            }
+
+        private:
+            typename std::vector<std::vector<std::pair<key, value>>>::iterator first, last;
+        };
+
+        /**
+         * Splits the buckets of the map into at most the given number of ranges of equal bucket counts, for parallel
+         * traversal, see dsl/parallel.h. Modifying the map invalidates the ranges.
+         */
+        std::vector<range> ranges(size_t parts) {
+            if (parts > num_buckets)
+                parts = num_buckets;
+
+            std::vector<range> ans(parts);
+            for (size_t i = 0; i < parts; i++) {
+                ans[i].first = buckets.begin() + i * num_buckets / parts;
+                ans[i].last = buckets.begin() + (i + 1) * num_buckets / parts;
+            }
+            return ans;
+        }
+
         explicit hashmap(size_t bucket_count) : buckets(bucket_count), num_buckets(bucket_count), count(0) {
 
         }
@@ -154,9 +215,12 @@ namespace dsl {
             size_t h = hasher(id) % num_buckets; //The index of the bucket
 
             for (size_t i = 0; i < buckets[h].size(); i++) {
-                if (comparator(id, buckets[h][i].first))
+                if (comparator(id, buckets[h][i].first)) {
+                    count_probes(i + 1);
                     return iterator({buckets.begin() + h, i, buckets.end()});
+                }
             }
+            count_probes(buckets[h].size());
             return end();
         }
 
@@ -166,9 +230,12 @@ namespace dsl {
             size_t h = hasher(element.first) % num_buckets; // The index of the bucket
 
             for (size_t i = 0; i < buckets[h].size(); i++) {
-                if (comparator(element.first, buckets[h][i].first))// We found an element with the same hash
+                if (comparator(element.first, buckets[h][i].first)) {// We found an element with the same hash
+                    count_probes(i + 1);
                     return;
+                }
             }
+            count_probes(buckets[h].size());
             count++;
             buckets[h].push_back(element);
         }
@@ -200,6 +267,48 @@ namespace dsl {
             count = 0;
         }
 
+        /** Returns the number of bytes used by the hashmap and its buckets. */
+        size_t memory_usage() const {
+            size_t ans = sizeof(*this) + buckets.capacity() * sizeof(buckets[0]);
+            for (const auto &bucket : buckets)
+                ans += bucket.capacity() * sizeof(std::pair<key, value>);
+            return ans;
+        }
+
+        /** Rehashes the map to at least the given number of buckets, so that it can hold that many elements with
+         * one element per bucket on average. Invalidates the iterators if it rehashes. */
+        void reserve(size_t elements) {
+            if (elements > num_buckets)
+                rehash(elements);
+        }
+
+        /** Rehashes the map to one bucket per element, if it has more buckets, and releases the unused capacity of
+         * the buckets. Invalidates the iterators. */
+        void shrink_to_fit() {
+            size_t needed = count > 0 ? count : 1;
+            if (needed < num_buckets)
+                rehash(needed);
+            for (auto &bucket : buckets)
+                bucket.shrink_to_fit();
+            buckets.shrink_to_fit();
+        }
+
+        /** Returns the bucket length histogram, and the average probe length when the statistics are collected. */
+        hashmap_statistics statistics() const {
+            hashmap_statistics ans;
+            for (const auto &bucket : buckets) {
+                if (bucket.size() >= ans.bucket_lengths.size())
+                    ans.bucket_lengths.resize(bucket.size() + 1);
+                ans.bucket_lengths[bucket.size()]++;
+            }
+            if constexpr (statistics_policy::enabled) {
+                ans.lookups = this->stats.lookups;
+                if (this->stats.lookups > 0)
+                    ans.average_probe_length = static_cast<double>(this->stats.probes) / this->stats.lookups;
+            }
+            return ans;
+        }
+
     };
 }
 
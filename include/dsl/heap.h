@@ -7,6 +7,7 @@
 
 #include<vector>
 #include<functional>
+#include"statistics.h"
 
 namespace dsl {
     /** This is an implementation of a priority queue, using a heap structure.
@@ -15,11 +16,12 @@ namespace dsl {
      *
      * @tparam type The type of the value of an entry in the heap.
      * @tparam compare A binary predicate that defines a strict weak ordering, used to order the elements.\n The expression compare(a,b) shall return true if a is considered to go before b.
+     * @tparam statistics_policy dsl::no_statistics, or dsl::collect_statistics to count how far push and pop move the elements.
      *
      */
-    template<class type, class compare=std::less<type>>
+    template<class type, class compare=std::less<type>, class statistics_policy=no_statistics>
 
-    class heap {
+    class heap : private statistics_policy::template storage<detail::heap_counters> {
     private:
         std::vector<type> data;
         size_t count;
@@ -40,6 +42,30 @@ namespace dsl {
             return node >> 1u;
         }
 
+        /* Count one level moved by the element being sifted */
+        void count_level() {
+            if constexpr (statistics_policy::enabled)
+                this->stats.levels++;
+        }
+
+        /* Count a sift, given the number of levels counted before it */
+        void count_sift(size_t levels_before) {
+            if constexpr (statistics_policy::enabled) {
+                this->stats.sifts++;
+                size_t levels = this->stats.levels - levels_before;
+                if (levels > this->stats.max_levels)
+                    this->stats.max_levels = levels;
+            }
+        }
+
+        /* Returns the number of levels counted so far */
+        size_t counted_levels() const {
+            if constexpr (statistics_policy::enabled)
+                return this->stats.levels;
+            else
+                return 0;
+        }
+
         /* This method shifts the node down the tree, comparing its value with the value of its children */
         void shift(size_t node) {
             size_t best, l = left_son(node), r = right_son(node);
@@ -60,6 +86,7 @@ namespace dsl {
 
                 if (comparator(data[node], data[best])) {
                     std::swap(data[node], data[best]);
+                    count_level();
                     shift(best);
                 }
             }
@@ -74,6 +101,7 @@ namespace dsl {
 
             if (ft != 0 && comparator(data[ft], data[node])) {
                 std::swap(data[node], data[ft]);
+                count_level();
                 percolate(ft);
             }
         }
@@ -98,6 +126,10 @@ namespace dsl {
             for (size_t node = count / 2; node >= 1; node--) {
                 shift(node);
             }
+
+            /* The statistics describe push and pop, not the build */
+            if constexpr (statistics_policy::enabled)
+                this->stats = detail::heap_counters();
         }
 
         /**
@@ -118,9 +150,11 @@ namespace dsl {
          * Inserts a new value into the heap.
          */
         void push(type value) {
+            size_t levels_before = counted_levels();
             data.push_back(value);
             count++;
             percolate(count);
+            count_sift(levels_before);
         }
 
         /**
@@ -130,13 +164,15 @@ namespace dsl {
             data[1] = data[count];
             data.pop_back();
             count--;
+            size_t levels_before = counted_levels();
             shift(1);
+            count_sift(levels_before);
         }
 
         /**
-         * Returns the value of the top element of the heap.
+         * Returns a reference to the top element of the heap.
          */
-        type top() const {
+        const type &top() const {
             return data[1];
         }
 
@@ -147,6 +183,41 @@ namespace dsl {
             data.resize(1);
             count = 0;
         }
+
+        /**
+         * Returns the number of bytes used by the heap and its array.
+         */
+        size_t memory_usage() const {
+            return sizeof(*this) + data.capacity() * sizeof(type);
+        }
+
+        /**
+         * Makes room for the given number of elements, so that pushing them does not reallocate the array.
+         */
+        void reserve(size_t elements) {
+            data.reserve(elements + 1);
+        }
+
+        /**
+         * Releases the unused capacity of the array.
+         */
+        void shrink_to_fit() {
+            data.shrink_to_fit();
+        }
+
+        /**
+         * Returns how far push and pop moved the elements, when the statistics are collected.
+         */
+        heap_statistics statistics() const {
+            heap_statistics ans;
+            if constexpr (statistics_policy::enabled) {
+                ans.sifts = this->stats.sifts;
+                ans.max_sift_depth = this->stats.max_levels;
+                if (this->stats.sifts > 0)
+                    ans.average_sift_depth = static_cast<double>(this->stats.levels) / this->stats.sifts;
+            }
+            return ans;
+        }
     };
 }
 
@@ -6,15 +6,22 @@
 #define DSL_LIST_H
 
 #include<iterator> //for std::forward_iterator tag
+#include<new> //for placement new
 #include<utility> //for std::swap
+#include"statistics.h"
 
 namespace dsl {
     /**
      * This class is an implementation of a doubly linked list.
+     *
+     * Erasing an element frees its node. After reserve(n), up to n nodes of erased elements are kept and reused by
+     * the next inserts instead, until shrink_to_fit releases them. The spare nodes belong to the list object: swapping
+     * or assigning the list exchanges the elements, but each list keeps its own spare nodes and reserved capacity.
      * @tparam type The type of a value of an entry in the list.
+     * @tparam statistics_policy dsl::no_statistics, or dsl::collect_statistics to count the node allocations.
      */
-    template<class type>
-    class list {
+    template<class type, class statistics_policy=no_statistics>
+    class list : private statistics_policy::template storage<detail::list_counters> {
     private:
         /* This structure represents a single entry in the list */
         struct node {
@@ -34,7 +41,7 @@ namespace dsl {
             }
         };
 
-        /* This node is used to mark the end of the list*/
+        /* This node is used to mark the end of the list. A moved-from list has none, until the next insert */
         node *last;
 
         /* The first node of the list */
@@ -43,12 +50,82 @@ namespace dsl {
         /* The number of elements in the list */
         size_t count;
 
+        /* The memory of a destroyed node, kept for the next insert */
+        struct spare {
+            spare *next;
+        };
+
+        /* The spare nodes kept since the last reserve */
+        struct spare_pool {
+            spare *spares = nullptr;
+            size_t spare_count = 0;
+
+            /* The largest number of spare nodes kept */
+            size_t reserved = 0;
+        };
+
+        /* The spare nodes, or nullptr if reserve was never called, so that a list which is not reserved frees its nodes */
+        spare_pool *pool;
+
+        /* Build a node in a spare node, or in a new one if there is none */
+        node *create_node(const type &value) {
+            void *memory;
+            if (pool != nullptr && pool->spares != nullptr) {
+                memory = pool->spares;
+                pool->spares = pool->spares->next;
+                pool->spare_count--;
+                if constexpr (statistics_policy::enabled)
+                    this->stats.reuses++;
+            } else {
+                memory = ::operator new(sizeof(node));
+                if constexpr (statistics_policy::enabled)
+                    this->stats.allocations++;
+            }
+
+            try {
+                return new(memory) node(value);
+            } catch (...) {
+                free_memory(memory);
+                throw;
+            }
+        }
+
+        /* Destroy the node, and keep its memory if the pool has room for it */
+        void destroy_node(node *here) {
+            here->~node();
+            free_memory(here);
+        }
+
+        void free_memory(void *memory) {
+            if (pool != nullptr && pool->spare_count < pool->reserved) {
+                pool->spares = new(memory) spare{pool->spares};
+                pool->spare_count++;
+            } else {
+                ::operator delete(memory);
+            }
+        }
+
+        /* Free the spare nodes and the pool */
+        void release_pool() {
+            if (pool == nullptr)
+                return;
+            while (pool->spares != nullptr) {
+                spare *next = pool->spares->next;
+                ::operator delete(pool->spares);
+                pool->spares = next;
+            }
+            delete pool;
+            pool = nullptr;
+        }
+
         /* Delete the nodes of the list, don't delete the end node */
         void destroy_list() {
+            if (last == nullptr)
+                return;
             node *here = first;
             while (here != last) {
                 node *next = here->next;
-                delete here;
+                destroy_node(here);
                 here = next;
             }
             last->previous = nullptr;
@@ -116,18 +193,18 @@ namespace dsl {
             node *h_node;
         };
 
-        list() : count(0) {
+        list() : count(0), pool(nullptr) {
             last = new node();
             first = last;
         }
 
         /** Copy constructor, make a copy of the other list. */
-        list(const list &other) : count(other.count) {
+        list(const list &other) : count(other.count), pool(nullptr) {
             last = new node();
             node *here = last, *current = other.last;
 
             while (current != other.first) {
-                node *copy = new node(current->previous->value);
+                node *copy = create_node(current->previous->value);
                 here->previous = copy;
                 copy->next = here;
                 here = copy;
@@ -142,12 +219,13 @@ namespace dsl {
             return *this;
         }
 
-        /** Swaps the content of this list with the content of the rvalue list. */
-        list(list &&other) noexcept: count(0) {
-            swap(other);
+        /** Move constructor, takes the nodes of the other list without allocating. The other list is left empty and keeps its spare nodes. */
+        list(list &&other) noexcept: last(other.last), first(other.first), count(other.count), pool(nullptr) {
+            other.last = other.first = nullptr;
+            other.count = 0;
         }
 
-        /** Swaps the content of this list with another list.*/
+        /** Swaps the content of this list with another list. Each list keeps its spare nodes. */
         void swap(list &other) {
             std::swap(first, other.first);
             std::swap(last, other.last);
@@ -156,6 +234,7 @@ namespace dsl {
 
         /** Destroys the list object.*/
         ~list() {
+            release_pool();
             destroy_list();
             delete last;
         }
@@ -174,7 +253,11 @@ namespace dsl {
          *
          * It returns an iterator to the newly inserted element. */
         iterator insert(iterator position, const type &value) {
-            node *to_add = new node(value);
+            if (last == nullptr) { // A moved-from list gets a new end node, the only position in it is the end
+                last = first = new node();
+                position = end();
+            }
+            node *to_add = create_node(value);
             node *next = position.h_node;
 
             to_add->next = next;
@@ -204,7 +287,7 @@ namespace dsl {
                 first = next;
             } else to_erase->previous->next = next;
 
-            delete to_erase;
+            destroy_node(to_erase);
             count--;
             return iterator(next);
         }
@@ -219,12 +302,51 @@ namespace dsl {
             return count == 0;
         }
 
-        /** Removes all the elements from the list. */
+        /** Removes all the elements from the list. Their nodes are freed, except the ones kept by reserve. */
         void clear() {
             destroy_list();
             count = 0;
         }
 
+        /** Returns the number of bytes used by the list, its nodes and its spare nodes. */
+        size_t memory_usage() const {
+            size_t ans = sizeof(*this) + (count + (last != nullptr ? 1 : 0)) * sizeof(node);
+            if (pool != nullptr)
+                ans += sizeof(spare_pool) + pool->spare_count * sizeof(node);
+            return ans;
+        }
+
+        /**
+         * Allocates spare nodes, so that the list can hold the given number of elements without allocating. From then
+         * on, erasing keeps the nodes for reuse, up to that number of spare nodes.
+         */
+        void reserve(size_t elements) {
+            if (pool == nullptr)
+                pool = new spare_pool();
+            if (pool->reserved < elements)
+                pool->reserved = elements;
+            while (count + pool->spare_count < elements) {
+                pool->spares = new(::operator new(sizeof(node))) spare{pool->spares};
+                pool->spare_count++;
+            }
+        }
+
+        /** Releases the spare nodes. Erasing frees the nodes again, until the next reserve. */
+        void shrink_to_fit() {
+            release_pool();
+        }
+
+        /** Returns the number of spare nodes, and the node allocations when the statistics are collected. */
+        list_statistics statistics() const {
+            list_statistics ans;
+            ans.spare_nodes = pool == nullptr ? 0 : pool->spare_count;
+            if constexpr (statistics_policy::enabled) {
+                ans.allocations = this->stats.allocations;
+                ans.reuses = this->stats.reuses;
+            }
+            return ans;
+        }
+
         /** Returns a reference to the first element.
          *
          * Calling this function when the list is empty results in undefined behaviour. */
@@ -0,0 +1,224 @@
+//
+// Created by gvisan on 18.10.2026.
+//
+
+#ifndef DSL_PARALLEL_H
+#define DSL_PARALLEL_H
+
+#include<condition_variable>
+#include<cstddef> //for size_t
+#include<exception> //for exception_ptr
+#include<functional> //for function
+#include<mutex>
+#include<thread>
+#include<utility> //for forward
+#include<vector>
+
+namespace dsl {
+
+    /**
+     * A fixed group of threads that run numbered tasks.
+     *
+     * The thread that calls run works on the tasks too, so a pool of n threads starts n - 1 of its own.
+     * Calls to run from several threads are served one after another. A call to run from inside a task runs its
+     * tasks on the calling thread.
+     */
+    class thread_pool {
+    private:
+
+        /* The tasks of one call to run. Every field is guarded by the lock of the pool */
+        struct job {
+            const std::function<void(size_t)> *work;
+            size_t tasks;
+            size_t next;
+            size_t finished;
+            std::exception_ptr failure;
+        };
+
+        /* The threads of the pool */
+        std::vector<std::thread> workers;
+
+        /* Guards the current job and the stopping flag */
+        std::mutex lock;
+
+        /* Only one job runs at a time */
+        std::mutex submit;
+
+        /* wake is notified when a job starts or the pool stops, done when the last task of a job finishes */
+        std::condition_variable wake, done;
+
+        /* The job being run, or nullptr */
+        job *current;
+
+        bool stopping;
+
+        /* Whether this thread is running a task of some pool */
+        static bool &inside_task() {
+            static thread_local bool flag = false;
+            return flag;
+        }
+
+        /* Runs the tasks of the job that are not yet taken. The lock must be held, it is released while a task runs */
+        static void take_tasks(job &work, std::unique_lock<std::mutex> &guard, std::condition_variable &done) {
+            while (work.next < work.tasks) {
+                size_t index = work.next++;
+                guard.unlock();
+
+                std::exception_ptr failure;
+                try {
+                    (*work.work)(index);
+                } catch (...) {
+                    failure = std::current_exception();
+                }
+
+                guard.lock();
+                if (failure && !work.failure)
+                    work.failure = failure;
+                if (++work.finished == work.tasks)
+                    done.notify_all();
+            }
+        }
+
+        void work_loop() {
+            inside_task() = true;
+            std::unique_lock<std::mutex> guard(lock);
+            while (true) {
+                wake.wait(guard, [this] { return stopping || (current != nullptr && current->next < current->tasks); });
+                if (stopping)
+                    return;
+                take_tasks(*current, guard, done);
+            }
+        }
+
+    public:
+
+        /** Creates a pool of the given number of threads, counting the one that calls run. */
+        explicit thread_pool(unsigned threads = std::thread::hardware_concurrency()) : current(nullptr), stopping(false) {
+            for (unsigned i = 1; i < threads; i++)
+                workers.emplace_back([this] { work_loop(); });
+        }
+
+        thread_pool(const thread_pool &) = delete;
+
+        thread_pool &operator=(const thread_pool &) = delete;
+
+        ~thread_pool() {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (std::thread &worker : workers)
+                worker.join();
+        }
+
+        /** Returns the number of threads that run the tasks, counting the one that calls run. */
+        size_t size() const {
+            return workers.size() + 1;
+        }
+
+        /**
+         * Calls work(i) for every i in [0, tasks), on the threads of the pool, and returns when all the calls
+         * returned. If some calls throw, the first exception is rethrown after the others finished.
+         */
+        template<class function>
+        void run(size_t tasks, function &&work) {
+            if (tasks == 0)
+                return;
+
+            if (workers.empty() || tasks == 1 || inside_task()) {
+                for (size_t i = 0; i < tasks; i++)
+                    work(i);
+                return;
+            }
+
+            std::lock_guard<std::mutex> serial(submit);
+            const std::function<void(size_t)> wrapped = [&work](size_t i) { work(i); };
+            job here{&wrapped, tasks, 0, 0, nullptr};
+
+            std::unique_lock<std::mutex> guard(lock);
+            current = &here;
+            wake.notify_all();
+
+            inside_task() = true;
+            take_tasks(here, guard, done);
+            inside_task() = false;
+
+            done.wait(guard, [&here] { return here.finished == here.tasks; });
+            current = nullptr;
+            guard.unlock();
+
+            if (here.failure)
+                std::rethrow_exception(here.failure);
+        }
+
+        /** Returns a pool with one thread per hardware thread, created on first use. */
+        static thread_pool &shared() {
+            static thread_pool pool;
+            return pool;
+        }
+    };
+
+    namespace detail {
+        /* The containers are split in this many ranges per thread, so that a thread that finished its range early
+         * can take another one */
+        constexpr size_t ranges_per_thread = 4;
+    }
+
+    /**
+     * Calls work(element) for every element of the container, on the threads of the pool.
+     *
+     * The container is split with its ranges method, available on dsl::set and dsl::hashmap. The calls on the
+     * same range are made in order, by one thread. The container must not be modified until the function returns.
+     */
+    template<class container, class function>
+    void parallel_for_each(container &elements, function &&work, thread_pool &pool = thread_pool::shared()) {
+        auto parts = elements.ranges(pool.size() * detail::ranges_per_thread);
+        pool.run(parts.size(), [&](size_t i) {
+            for (auto &element : parts[i])
+                work(element);
+        });
+    }
+
+    /**
+     * Returns the combination of transform(element) over all the elements of the container, computed on the threads
+     * of the pool.
+     *
+     * Each range of the container is reduced from identity in order, then the results of the ranges are combined
+     * in the order of the ranges. The result is well defined if combine is associative and identity is its
+     * identity element.
+     */
+    template<class container, class type, class combine_function, class transform_function>
+    type parallel_reduce(container &elements, type identity, combine_function combine, transform_function transform,
+                         thread_pool &pool = thread_pool::shared()) {
+        auto parts = elements.ranges(pool.size() * detail::ranges_per_thread);
+        std::vector<type> partial(parts.size(), identity);
+        pool.run(parts.size(), [&](size_t i) {
+            type ans = identity;
+            for (auto &element : parts[i])
+                ans = combine(std::move(ans), transform(element));
+            partial[i] = std::move(ans);
+        });
+
+        type ans = identity;
+        for (type &value : partial)
+            ans = combine(std::move(ans), std::move(value));
+        return ans;
+    }
+
+    /** Returns the combination of all the elements of the container, computed on the threads of the pool. */
+    template<class container, class type, class combine_function>
+    type parallel_reduce(container &elements, type identity, combine_function combine) {
+        return parallel_reduce(elements, std::move(identity), combine, [](const auto &element) { return element; });
+    }
+
+    /** Returns the number of elements of the container that satisfy the predicate, counted on the threads of the pool. */
+    template<class container, class predicate>
+    size_t parallel_count_if(container &elements, predicate condition, thread_pool &pool = thread_pool::shared()) {
+        return parallel_reduce(elements, size_t(0), [](size_t a, size_t b) { return a + b; },
+                               [&condition](const auto &element) { return condition(element) ? size_t(1) : size_t(0); },
+                               pool);
+    }
+}
+
+#endif //DSL_PARALLEL_H
@@ -0,0 +1,444 @@
+//
+// Created by gvisan on 18.10.2026.
+//
+
+#ifndef DSL_PERSISTENT_SET_H
+#define DSL_PERSISTENT_SET_H
+
+#include<atomic> //for atomic reference counts and the published version
+#include<cstddef> //for size_t
+#include<cstdint> //for uint64_t
+#include<functional> //for less
+#include<iterator> //for std::bidirectional_iterator_tag
+#include<utility> //for swap
+#include<vector>
+#include"epoch.h"
+#include"seed.h"
+
+namespace dsl {
+
+    /**
+     * This class is an implementation of a persistent ordered set using a treap data structure.
+     *
+     * The nodes are never modified once built. Inserting or erasing copies only the O(log n) nodes on the path to the
+     * key and shares the rest of the tree with the previous version, through atomic reference counts.
+     * Taking a snapshot is O(1). Copying a persistent_set is the same as taking a snapshot.
+     *
+     * One thread may modify the set while other threads call snapshot() on it or copy it. The writer publishes each
+     * version through an atomic pointer and never waits for the readers: a reader only loads the pointer and takes a
+     * reference to the root, and the version it may be reading is deleted through epoch-based reclamation once no
+     * reader can hold it. Every other member function must not run while the set is modified. Readers should take a
+     * snapshot and read it instead, a snapshot is never modified by the writer and can be read without any locking.
+     *
+     * Iterators are invalidated when the set they come from is modified, iterate a snapshot to read while writing.
+     *
+     * @tparam key The type of the value of an entry in the set.
+     * @tparam compare A binary predicate that defines a strict weak ordering, used to order the elements.\n The expression compare(a,b) shall return true if a is considered to go before b.
+     */
+    template<class key, class compare=std::less<key>>
+    class persistent_set {
+    private:
+
+        /* A node in the tree structure, shared by all the versions that contain it */
+        struct node {
+            const key key_value;
+            const size_t priority;
+            const node *const left, *const right;
+
+            /* The number of versions and nodes that point to this node */
+            mutable std::atomic<size_t> references;
+
+            /* The new node takes over one reference to each of its sons */
+            node(const key &value, size_t pr, const node *l, const node *r) : key_value(value), priority(pr), left(l),
+                                                                               right(r), references(1) {
+
+            }
+        };
+
+        /* A version of the set. It holds one reference to its root */
+        struct version {
+            const node *root;
+
+            /* The number of nodes in this version */
+            size_t count;
+        };
+
+        /* The version held by this set, nullptr if it is empty. The writer replaces it, readers only load it */
+        std::atomic<const version *> current;
+
+        /*The comparator, used to compare keys */
+        compare comparator;
+
+        /* The state of the random generator used for priorities */
+        uint64_t seed;
+
+        /* Returns the root of the version held by this set */
+        const node *root() const {
+            const version *here = current.load(std::memory_order_acquire);
+            return here == nullptr ? nullptr : here->root;
+        }
+
+        /* Returns a new version that shares the nodes of the given one, or nullptr if it is empty. Must be called in a
+         * critical section of the epoch domain if the version may be replaced meanwhile */
+        static const version *share(const version *here) {
+            if (here == nullptr || here->root == nullptr)
+                return nullptr;
+            return new version{acquire(here->root), here->count};
+        }
+
+        /* Delete the version and drop its reference to the root */
+        static void destroy_version(const version *here) {
+            if (here != nullptr) {
+                release(here->root);
+                delete here;
+            }
+        }
+
+        static void destroy_retired(void *here) {
+            destroy_version(static_cast<const version *>(here));
+        }
+
+        /* Returns the next priority from the xorshift64* generator of this set */
+        size_t next_priority() {
+            seed ^= seed >> 12u;
+            seed ^= seed << 25u;
+            seed ^= seed >> 27u;
+            return static_cast<size_t>(seed * 0x2545F4914F6CDD1DULL);
+        }
+
+        /* Seeds the generator, differently for every set even when built at the same address */
+        void seed_generator() {
+            seed = detail::fresh_seed(this) | 1u;
+        }
+
+        /* Take one more reference to the node */
+        static const node *acquire(const node *here) {
+            if (here != nullptr)
+                here->references.fetch_add(1, std::memory_order_relaxed);
+            return here;
+        }
+
+        /* Drop one reference to the node, deleting it and releasing its sons if it was the last one */
+        static void release(const node *here) {
+            if (here != nullptr && here->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                release(here->left);
+                release(here->right);
+                delete here;
+            }
+        }
+
+        /* The functions below take borrowed pointers and return new references */
+
+        /* Split the subtree into the nodes that go before the key and the nodes that go after it. The key must not be in the subtree */
+        void split(const node *here, const key &key_value, const node *&left, const node *&right) {
+            if (here == nullptr) {
+                left = right = nullptr;
+                return;
+            }
+
+            if (comparator(here->key_value, key_value)) {
+                const node *split_left;
+                split(here->right, key_value, split_left, right);
+                left = new node(here->key_value, here->priority, acquire(here->left), split_left);
+            } else {
+                const node *split_right;
+                split(here->left, key_value, left, split_right);
+                right = new node(here->key_value, here->priority, split_right, acquire(here->right));
+            }
+        }
+
+        /* Join two subtrees, where all the nodes of the left one go before the nodes of the right one */
+        const node *join(const node *left, const node *right) {
+            if (left == nullptr)
+                return acquire(right);
+            if (right == nullptr)
+                return acquire(left);
+
+            if (left->priority > right->priority)
+                return new node(left->key_value, left->priority, acquire(left->left), join(left->right, right));
+            return new node(right->key_value, right->priority, join(left, right->left), acquire(right->right));
+        }
+
+        /* Returns a new version of the subtree with the key inserted. The key must not be in the subtree */
+        const node *insert(const node *here, const key &key_value, size_t priority) {
+            if (here == nullptr || priority > here->priority) { // The new node becomes the root of this subtree
+                const node *left, *right;
+                split(here, key_value, left, right);
+                return new node(key_value, priority, left, right);
+            }
+
+            if (comparator(key_value, here->key_value))
+                return new node(here->key_value, here->priority, insert(here->left, key_value, priority),
+                                acquire(here->right));
+            return new node(here->key_value, here->priority, acquire(here->left),
+                            insert(here->right, key_value, priority));
+        }
+
+        /* Returns a new version of the subtree without the key. The key must be in the subtree */
+        const node *erase(const node *here, const key &key_value) {
+            if (comparator(key_value, here->key_value))
+                return new node(here->key_value, here->priority, erase(here->left, key_value), acquire(here->right));
+            if (comparator(here->key_value, key_value))
+                return new node(here->key_value, here->priority, acquire(here->left), erase(here->right, key_value));
+            return join(here->left, here->right);
+        }
+
+        /* Publish a new version, taking over the reference to its root. The old version is retired, a reader that
+         * loaded it before the exchange can still take its reference to the root */
+        void replace_root(const node *new_root, size_t new_count) {
+            publish(new_root == nullptr ? nullptr : new version{new_root, new_count});
+        }
+
+        void publish(const version *fresh) {
+            detail::epoch_guard guard;
+            const version *old = current.exchange(fresh, std::memory_order_acq_rel);
+            if (old != nullptr)
+                detail::epoch_domain::instance().retire(const_cast<version *>(old), &destroy_retired);
+        }
+
+    public:
+
+        /**
+         * This is the iterator for the set.
+         * Iterating through the set returns the elements in the order defined by the compare predicate
+         *
+         * The nodes have no parent links, since they are shared by many versions, so the iterator keeps the path from the root.
+         */
+        struct iterator {
+            friend class persistent_set;
+
+            using iterator_category = std::bidirectional_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = const key;
+            using pointer = const key *;
+            using reference = const key &;
+
+            explicit iterator(const node *root) : h_root(root) {
+
+            }
+
+            /** De-references the iterator. */
+            reference operator*() const {
+                return h_path.back()->key_value;
+            }
+
+            /** De-references the iterator. */
+            pointer operator->() {
+                return &h_path.back()->key_value;
+            }
+
+            /** Incrementing this iterator is finding the successor of the element the iterator points at. */
+            iterator &operator++() {
+                const node *here = h_path.back();
+                if (here->right != nullptr) { //Its successor is the minimum node in its right subtree
+                    push_minimum(here->right);
+                    return *this;
+                }
+
+                //Search up the path
+                h_path.pop_back();
+                while (!h_path.empty() && h_path.back()->right == here) {
+                    here = h_path.back();
+                    h_path.pop_back();
+                }
+                return *this;
+            }
+
+            /** Post-increment, same as pre-increment, but return the value before the increment. */
+            iterator operator++(int) {
+                iterator tmp = *this;
+                ++*this;
+                return tmp;
+            }
+
+            /** Decrementing this iterator is finding the predecessor of the element the iterator points at. */
+            iterator &operator--() {
+                if (h_path.empty()) { //If its the end iterator, jump to the greatest value in the tree
+                    push_maximum(h_root);
+                    return *this;
+                }
+
+                const node *here = h_path.back();
+                if (here->left != nullptr) {
+                    push_maximum(here->left);
+                    return *this;
+                }
+
+                h_path.pop_back();
+                while (!h_path.empty() && h_path.back()->left == here) {
+                    here = h_path.back();
+                    h_path.pop_back();
+                }
+                return *this;
+            }
+
+            /** Post-decrement, same as pre-decrement, but return the value before the decrement. */
+            iterator operator--(int) {
+                iterator tmp = *this;
+                --*this;
+                return tmp;
+            }
+
+            /** Checks if two iterators are equal. */
+            friend bool operator==(const iterator &a, const iterator &b) {
+                return a.position() == b.position();
+            };
+
+            /** Checks if two iterators are not equal. */
+            friend bool operator!=(const iterator &a, const iterator &b) {
+                return a.position() != b.position();
+            };
+
+        private:
+            /* The root of the version being iterated */
+            const node *h_root;
+
+            /* The nodes from the root to the position of the iterator. It is empty for the end iterator */
+            std::vector<const node *> h_path;
+
+            const node *position() const {
+                return h_path.empty() ? nullptr : h_path.back();
+            }
+
+            void push_minimum(const node *here) {
+                for (; here != nullptr; here = here->left)
+                    h_path.push_back(here);
+            }
+
+            void push_maximum(const node *here) {
+                for (; here != nullptr; here = here->right)
+                    h_path.push_back(here);
+            }
+        };
+
+        persistent_set() : current(nullptr) {
+            seed_generator();
+        }
+
+        /** Copy constructor, shares the version of the other set in O(1). It may run while another thread modifies the
+         * other set, and never makes that thread wait. */
+        persistent_set(const persistent_set &other) : comparator(other.comparator) {
+            detail::epoch_guard guard;
+            current.store(share(other.current.load(std::memory_order_acquire)), std::memory_order_relaxed);
+            seed_generator();
+        }
+
+        /** Assigns new contents to the set, replacing its current contents. This modifies the set, so it may run while
+         * other threads take snapshots of it. */
+        persistent_set &operator=(persistent_set other) {
+            publish(other.current.exchange(nullptr, std::memory_order_relaxed));
+            comparator = std::move(other.comparator);
+            return *this;
+        }
+
+        /** Swaps the content of this set with another set. This modifies both sets, no version is deleted by it. */
+        void swap(persistent_set &other) {
+            const version *mine = current.load(std::memory_order_relaxed);
+            current.store(other.current.load(std::memory_order_relaxed), std::memory_order_release);
+            other.current.store(mine, std::memory_order_release);
+            std::swap(comparator, other.comparator);
+        }
+
+        /** Destroys the set object, the nodes shared with other versions are kept. No other thread may use the set anymore. */
+        ~persistent_set() {
+            destroy_version(current.load(std::memory_order_relaxed));
+        }
+
+        /**
+         * Returns a read-only version of the current content in O(1).
+         *
+         * The snapshot is not affected by later changes to this set. It may be taken by another thread while one
+         * thread modifies this set, and read from any thread without locking.
+         */
+        persistent_set snapshot() const {
+            return *this;
+        }
+
+        /** Returns an iterator to the first element in the set. */
+        iterator begin() const {
+            iterator ans(root());
+            ans.push_minimum(ans.h_root);
+            return ans;
+        }
+
+        /** Returns an iterator that represents the end of the set. */
+        iterator end() const {
+            return iterator(root());
+        }
+
+        /** Insert a new entry with the given key value, copying the nodes on its path. **/
+        void insert(const key &key_value) {
+            if (find(key_value) != end())
+                return;
+            replace_root(insert(root(), key_value, next_priority()), size() + 1);
+        }
+
+        /** Returns an iterator that points to the element with the given key. If no element with the given key is found in the set, return the end iterator. */
+        iterator find(const key &key_value) const {
+            iterator ans = lower_bound(key_value);
+            if (!ans.h_path.empty() && comparator(key_value, *ans))
+                return end();
+            return ans;
+        }
+
+        /** Returns an iterator to the first element which is not considered to go before the given value. */
+        iterator lower_bound(const key &value) const {
+            iterator ans(root());
+            size_t length = 0; // The length of the path to the best node so far
+            for (const node *here = ans.h_root; here != nullptr;) {
+                ans.h_path.push_back(here);
+                if (comparator(here->key_value, value)) {
+                    here = here->right;
+                } else {
+                    length = ans.h_path.size();
+                    here = here->left;
+                }
+            }
+            ans.h_path.resize(length);
+            return ans;
+        }
+
+        /** Returns an iterator to the first element which is considered to go after the given value. */
+        iterator upper_bound(const key &value) const {
+            iterator ans(root());
+            size_t length = 0;
+            for (const node *here = ans.h_root; here != nullptr;) {
+                ans.h_path.push_back(here);
+                if (comparator(value, here->key_value)) {
+                    length = ans.h_path.size();
+                    here = here->left;
+                } else {
+                    here = here->right;
+                }
+            }
+            ans.h_path.resize(length);
+            return ans;
+        }
+
+        /** Removes an element from the set by iterator, copying the nodes on its path.
+         * Erasing the end iterator does nothing. */
+        void erase(iterator to_erase) {
+            if (to_erase.h_path.empty())
+                return;
+            replace_root(erase(root(), *to_erase), size() - 1);
+        }
+
+        /** Returns the number of elements in the set. */
+        size_t size() const {
+            const version *here = current.load(std::memory_order_acquire);
+            return here == nullptr ? 0 : here->count;
+        }
+
+        /** Checks if the container is empty. */
+        bool empty() const {
+            return size() == 0;
+        }
+
+        /** Removes all the elements from the set. The snapshots keep their content. */
+        void clear() {
+            replace_root(nullptr, 0);
+        }
+    };
+}
+
+#endif //DSL_PERSISTENT_SET_H
@@ -0,0 +1,36 @@
+//
+// Created by gvisan on 18.10.2026.
+//
+
+#ifndef DSL_SEED_H
+#define DSL_SEED_H
+
+#include<atomic> //for atomic
+#include<cstdint> //for uint64_t, uintptr_t
+#include<random> //for random_device
+
+namespace dsl {
+
+    namespace detail {
+
+        /*
+         * Returns a new seed for the random generator of a container, through the splitmix64 finalizer.
+         *
+         * It mixes a random value drawn once per process, a counter of the seeds handed out and the address of the
+         * container, so a container built again at the same address, or the same program run twice, does not draw
+         * the same sequence.
+         */
+        inline uint64_t fresh_seed(const void *address) {
+            static const uint64_t process = (uint64_t(std::random_device()()) << 32u) ^ std::random_device()();
+            static std::atomic<uint64_t> handed_out{0};
+
+            uint64_t z = process ^ reinterpret_cast<uintptr_t>(address);
+            z += (handed_out.fetch_add(1, std::memory_order_relaxed) + 1) * 0x9E3779B97F4A7C15ULL;
+            z = (z ^ (z >> 30u)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27u)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31u);
+        }
+    }
+}
+
+#endif //DSL_SEED_H
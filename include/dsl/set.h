@@ -6,40 +6,215 @@
 #define DSL_SET_H
 
 #include<cstddef> //for size_t
+#include<cstdint> //for uint64_t
+#include<algorithm> //for sort, unique
+#include<atomic> //for atomic
 #include<functional> //for less
+#include<future> //for async
+#include<iterator> //for distance, iterator_traits
+#include<memory> //for shared_ptr
+#include<new> //for placement new
+#include<thread> //for hardware_concurrency
+#include<type_traits> //for is_trivially_destructible, is_base_of
+#include<utility> //for swap
+#include<vector>
+#include"seed.h"
+#include"statistics.h"
 
 namespace dsl {
 
+    /**
+     * The default augmentation policy of dsl::set, it stores nothing in the nodes and costs nothing.
+     */
+    struct no_augmentation {
+        /** The data added to every node of the tree. */
+        struct node_data {
+        };
+
+        /** Whether the node data has to be recomputed when the tree changes. */
+        static constexpr bool maintained = false;
+
+        /** Whether the nodes know the size of their subtree. */
+        static constexpr bool counts_subtrees = false;
+
+        /** Whether the nodes keep the aggregate of their subtree. */
+        static constexpr bool aggregates = false;
+
+        /** Recomputes the data of a node from its sons. */
+        template<class node>
+        static void update(node *) {
+
+        }
+    };
+
+    /**
+     * An augmentation policy of dsl::set that stores the size of every subtree.
+     *
+     * It enables nth, rank, count_range and distance in O(log n), for one more size_t per node.
+     */
+    struct order_statistics {
+        /** The data added to every node of the tree. */
+        struct node_data {
+            /* The number of nodes in the subtree of this node, nil has 0 */
+            size_t subtree_size = 0;
+        };
+
+        /** Whether the node data has to be recomputed when the tree changes. */
+        static constexpr bool maintained = true;
+
+        /** Whether the nodes know the size of their subtree. */
+        static constexpr bool counts_subtrees = true;
+
+        /** Whether the nodes keep the aggregate of their subtree. */
+        static constexpr bool aggregates = false;
+
+        /** Recomputes the data of a node from its sons. */
+        template<class node>
+        static void update(node *here) {
+            here->subtree_size = here->left->subtree_size + here->right->subtree_size + 1;
+        }
+    };
+
+    /**
+     * An augmentation policy of dsl::set that keeps, in every node, the aggregate of the keys in its subtree.
+     *
+     * It enables aggregate(low, high) in O(log n). To keep a value next to every key, like an ordered map, use a pair
+     * as the key with a comparator that only looks at its first member, and lift the second member.
+     *
+     * @tparam monoid_type A type with a value_type, and the static functions identity(), lift(key) that returns the
+     * value of one key, and combine(a,b) that is associative and has identity() as the neutral element.
+     */
+    template<class monoid_type>
+    struct augmented {
+        /** The monoid that is aggregated. */
+        using monoid = monoid_type;
+
+        /** The data added to every node of the tree. */
+        struct node_data {
+            /* The aggregate of the keys in the subtree of this node, in order. It is the identity for nil */
+            typename monoid::value_type aggregate = monoid::identity();
+        };
+
+        /** Whether the node data has to be recomputed when the tree changes. */
+        static constexpr bool maintained = true;
+
+        /** Whether the nodes know the size of their subtree. */
+        static constexpr bool counts_subtrees = false;
+
+        /** Whether the nodes keep the aggregate of their subtree. */
+        static constexpr bool aggregates = true;
+
+        /** Recomputes the data of a node from its sons. */
+        template<class node>
+        static void update(node *here) {
+            here->aggregate = monoid::combine(monoid::combine(here->left->aggregate, monoid::lift(here->key_value)),
+                                              here->right->aggregate);
+        }
+    };
+
+    namespace detail {
+        /* The number of levels the set algebra forks, overriding the choice made from the size of the trees and the
+         * number of cores, or -1 to keep that choice. The tests set it to run the parallel code on any machine */
+        inline std::atomic<int> set_algebra_fork_depth{-1};
+    }
+
     /**
      * This class is an implementation of an ordered set using a treap data structure.
      *
      * @tparam key The type of the value of an entry in the set.
      * @tparam compare A binary predicate that defines a strict weak ordering, used to order the elements.\n The expression compare(a,b) shall return true if a is considered to go before b.
+     * @tparam augmentation A policy that defines extra data kept in every node, like dsl::no_augmentation, dsl::order_statistics or dsl::augmented.
+     * @tparam statistics_policy dsl::no_statistics, or dsl::collect_statistics to count the rotations done by insert.
      */
 
-    template<class key, class compare=std::less<key>>
+    template<class key, class compare=std::less<key>, class augmentation=no_augmentation,
+            class statistics_policy=no_statistics>
     class set {
     private:
 
         /* A node in the tree structure */
-        struct node {
+        struct node : public augmentation::node_data {
             const key key_value;
             size_t priority;
             node *left, *right, *parent;
 
-            node(key value, size_t pr, node *l, node *r, node *p) : key_value(value), priority(pr), left(l), right(r),
+            node(key value, size_t pr, node *l, node *r, node *p) : augmentation::node_data(), key_value(value), priority(pr), left(l), right(r),
                                                                     parent(p) {
 
             }
+
+            node() : augmentation::node_data(), key_value(), priority(0), left(nullptr), right(nullptr), parent(nullptr) {
+
+            }
+        };
+
+        /* The memory for one node. Nodes are built in blocks of slots */
+        struct alignas(node) slot {
+            unsigned char bytes[sizeof(node)];
+        };
+
+        /* A list of slots whose nodes were destroyed. The link to the next slot is kept in the slot itself */
+        struct free_list {
+            struct free_slot {
+                free_slot *next;
+            };
+
+            free_slot *head = nullptr, *tail = nullptr;
+
+            /* The number of slots in the list */
+            size_t size = 0;
+
+            void push(slot *here) {
+                free_slot *added = new(here) free_slot{head};
+                if (head == nullptr)
+                    tail = added;
+                head = added;
+                size++;
+            }
+
+            slot *pop() {
+                free_slot *here = head;
+                head = head->next;
+                if (head == nullptr)
+                    tail = nullptr;
+                size--;
+                return reinterpret_cast<slot *>(here);
+            }
+
+            /* Move all the slots of the other list to this list */
+            void splice(free_list &other) {
+                if (other.head == nullptr)
+                    return;
+                other.tail->next = head;
+                if (head == nullptr)
+                    tail = other.tail;
+                head = other.head;
+                size += other.size;
+                other.head = other.tail = nullptr;
+                other.size = 0;
+            }
         };
 
+        /* Nodes allocated one by one come from blocks of at least this many slots */
+        static constexpr size_t min_block = 32;
+
+        /* The dummy node shared by all the trees of this type. It is never modified, so subtrees can be moved
+         * from one tree to another without touching their leaves */
+        static node *sentinel() {
+            static node nil_node;
+            return &nil_node;
+        }
+
+        /* Set algebra on trees with fewer nodes than this runs on a single thread */
+        static constexpr size_t parallel_cutoff = 1u << 16u;
+
         /* The tree structure */
-        struct tree {
+        struct tree : public statistics_policy::template storage<detail::set_counters> {
         public:
             /* The root of the tree */
             node *root;
 
-            /* A dummy node, used to mark the end of the container */
+            /* A dummy node, used to mark the end of the container. It is the same for all trees */
             node *nil;
 
             /*The comparator, used to compare keys */
@@ -48,6 +223,94 @@ namespace dsl {
             /* The number of nodes in the tree structure */
             size_t count;
 
+            /* The state of the random generator used for priorities, every tree has its own */
+            uint64_t seed;
+
+            /* The blocks that hold the nodes of the tree. A block is shared by all the trees that have nodes in it,
+             * since split and the set algebra move nodes between trees */
+            std::vector<std::shared_ptr<slot>> blocks;
+
+            /* The slots of destroyed nodes, they are reused before the unused part of the last block */
+            free_list free_slots;
+
+            /* The unused part of the last block */
+            slot *unused, *unused_end;
+
+            /* Allocate a new block with the given number of slots, which becomes the unused part */
+            void allocate_block(size_t slots) {
+                while (unused != unused_end) // Keep the rest of the previous block
+                    free_slots.push(unused++);
+
+                blocks.emplace_back(new slot[slots], std::default_delete<slot[]>());
+                unused = blocks.back().get();
+                unused_end = unused + slots;
+            }
+
+            /* Make sure that the next nodes are built contiguously in one block */
+            void reserve(size_t nodes) {
+                if (static_cast<size_t>(unused_end - unused) < nodes)
+                    allocate_block(nodes);
+            }
+
+            /* Make sure that the nodes of the keys of the range are built contiguously in one block. Input iterators
+             * can only be read once, so their range is not counted and the nodes are allocated as they come */
+            template<class Iter>
+            void reserve_range(Iter first, Iter last) {
+                using category = typename std::iterator_traits<Iter>::iterator_category;
+                if constexpr (std::is_base_of<std::forward_iterator_tag, category>::value)
+                    reserve(static_cast<size_t>(std::distance(first, last)));
+            }
+
+            /* Build a new node in a free slot */
+            node *create_node(const key &key_value, size_t priority) {
+                slot *here;
+                if (free_slots.head != nullptr) {
+                    here = free_slots.pop();
+                } else {
+                    if (unused == unused_end)
+                        allocate_block(count < min_block ? min_block : count);
+                    here = unused++;
+                }
+                node *created = new(here) node(key_value, priority, nil, nil, nil);
+                update(created);
+                return created;
+            }
+
+            /* Destroy the node and add its slot to the list */
+            static void destroy_node(node *here, free_list &garbage) {
+                here->~node();
+                garbage.push(reinterpret_cast<slot *>(here));
+            }
+
+            /* Take the blocks and the free slots of the other tree, whose nodes were moved to this tree */
+            void adopt_storage(tree &other) {
+                while (other.unused != other.unused_end)
+                    free_slots.push(other.unused++);
+                free_slots.splice(other.free_slots);
+
+                blocks.insert(blocks.end(), other.blocks.begin(), other.blocks.end());
+                other.blocks.clear();
+
+                /* The two trees may have shared blocks */
+                std::sort(blocks.begin(), blocks.end());
+                blocks.erase(std::unique(blocks.begin(), blocks.end()), blocks.end());
+            }
+
+            /* Recompute the augmentation data of the node */
+            void update(node *here) {
+                augmentation::template update<node>(here);
+            }
+
+            /* Recompute the augmentation data of the node and of all its ancestors */
+            void update_path(node *here) {
+                if (!augmentation::maintained)
+                    return;
+                while (here != nil) {
+                    update(here);
+                    here = here->parent;
+                }
+            }
+
             /* Left-rotation in the tree */
             void rotate_left(node *&here) {
                 node *left = here->left;
@@ -60,6 +323,8 @@ namespace dsl {
                 left->right = here;
                 here->parent = left;
 
+                update(here);
+                update(left);
                 here = left;
             }
 
@@ -76,6 +341,8 @@ namespace dsl {
                 right->left = here;
                 here->parent = right;
 
+                update(here);
+                update(right);
                 here = right;
             }
 
@@ -126,154 +393,559 @@ namespace dsl {
             }
 
 
-            /* Balance to keep the heap property of the priorities */
-            void balance(node *&n) {
-                if (n->left->priority > n->priority) {
-                    rotate_left(n);
-                } else if (n->right->priority > n->priority) {
-                    rotate_right(n);
-                }
+            /* Returns a reference to the link that points to the given node: the root or a child pointer of its parent */
+            node *&link_to(node *here) {
+                if (here->parent == nil)
+                    return root;
+                return here == here->parent->left ? here->parent->left : here->parent->right;
             }
 
-            /* Insert a new node with the given key */
-            void insert(node *&here, node *parent, const key &key_value) {
-                if (here == nil) {
-                    here = new node(key_value, rand() + 1, nil, nil, parent);
-                    count++;
-                    return;
+            /* Returns the next priority from the xorshift64* generator of this tree. Priorities are never 0, that is the priority of nil */
+            size_t next_priority() {
+                seed ^= seed >> 12u;
+                seed ^= seed << 25u;
+                seed ^= seed >> 27u;
+                return static_cast<size_t>(seed * 0x2545F4914F6CDD1DULL) | 1u;
+            }
+
+            /* Seeds the generator of this tree, differently for every tree even when built at the same address */
+            void seed_generator() {
+                seed = detail::fresh_seed(this) | 1u;
+            }
+
+            /* Insert a new node with the given key into the subtree of start, whose range of keys must contain it.
+             * Returns the node with the given key */
+            node *insert(node *start, const key &key_value) {
+                node *parent = start == nil ? nil : start->parent, *candidate = nil;
+                node **here = start == nil ? &root : &link_to(start);
+
+                /* Walk down with one comparison per level, remembering the last node that does not go after the key */
+                while (*here != nil) {
+                    parent = *here;
+                    if (comparator(key_value, parent->key_value)) {
+                        here = &parent->left;
+                    } else {
+                        candidate = parent;
+                        here = &parent->right;
+                    }
                 }
 
-                /* Check for equality first */
-                if (!comparator(key_value, here->key_value) && !comparator(here->key_value, key_value))
-                    return;
+                /* The candidate does not go after the key, so the key is already in the tree if it does not go before it either */
+                if (candidate != nil && !comparator(candidate->key_value, key_value))
+                    return candidate;
+
+                node *added = create_node(key_value, next_priority());
+                added->parent = parent;
+                *here = added;
+                count++;
+
+                /* Rotate the new node up while it breaks the heap property of the priorities */
+                while (added->parent != nil && added->priority > added->parent->priority) {
+                    node *&link = link_to(added->parent);
+                    (link->left == added) ? rotate_left(link) : rotate_right(link);
+                    if constexpr (statistics_policy::enabled)
+                        this->stats.rotations++;
+                }
+                update_path(added->parent);
+                if constexpr (statistics_policy::enabled)
+                    this->stats.inserts++;
+                return added;
+            }
 
-                if (comparator(key_value, here->key_value)) {
-                    insert(here->left, here, key_value);
-                } else {
-                    insert(here->right, here, key_value);
+            /* Returns the lowest ancestor of the node whose range of keys contains the value, which must not go
+             * before the key of the node. Used to continue a search from the previous result */
+            node *climb(node *here, const key &key_value) {
+                while (here->parent != nil) {
+                    node *parent = here->parent;
+                    if (here == parent->left && comparator(key_value, parent->key_value))
+                        break; // The parent bounds the range of this subtree and goes after the value
+                    here = parent;
                 }
-                balance(here);
+                return here;
             }
 
             /* Erase the given node from the tree */
-            void erase(node *&here, node *to_delete) {
-                if (here == nil)
+            void erase(node *to_delete) {
+                if (to_delete == nil)
                     return;
 
-                if (!comparator(to_delete->key_value, here->key_value) &&
-                    !comparator(here->key_value, to_delete->key_value)) {
-                    /* We found a match */
-                    if (here->left == nil && here->right == nil) {//This is a leaf node, so delete it
-                        delete here;
-                        here = nil;
-                        count--;
-                    } else {//We rotate it while keeping the heap property and continue downwards
-                        (here->left->priority > here->right->priority) ? rotate_left(here) : rotate_right(here);
-                        erase(here, to_delete);
+                /* Rotate it down while keeping the heap property, until it becomes a leaf */
+                while (to_delete->left != nil || to_delete->right != nil) {
+                    node *&link = link_to(to_delete);
+                    (to_delete->left->priority > to_delete->right->priority) ? rotate_left(link) : rotate_right(link);
+                }
+
+                link_to(to_delete) = nil;
+                update_path(to_delete->parent);
+                destroy_node(to_delete, free_slots);
+                count--;
+            }
+
+            /* Returns the first node that does not go before the value.*/
+            /* Either it is equivalent, or goes after */
+            /* If there is no such element, return nil */
+            node *lower_bound(const key &key_value) {
+                return lower_bound(root, nil, key_value);
+            }
+
+            /* Same as lower_bound, but search only the given subtree. If there is no such node in it, return ans */
+            node *lower_bound(node *here, node *ans, const key &key_value) {
+                while (here != nil) {
+                    if (comparator(here->key_value, key_value)) {
+                        here = here->right;
+                    } else {
+                        ans = here;
+                        here = here->left;
                     }
-                    return;
                 }
+                return ans;
+            }
 
-                if (comparator(to_delete->key_value, here->key_value)) {
-                    erase(here->left, to_delete);
-                } else {
-                    erase(here->right, to_delete);
+            /* Returns the lower bound of the value, given the lower bound of a previous value that does not go after it.
+             * The search climbs from the previous result only as far as needed, then goes down */
+            node *lower_bound_from(node *finger, const key &key_value) {
+                if (finger == nil || !comparator(finger->key_value, key_value))
+                    return finger; // The previous answer is still the first node that does not go before the value
+
+                node *here = climb(finger, key_value);
+                return lower_bound(here, here->parent, key_value); // The parent, if any, goes after the value
+            }
+
+            /* Returns the first node that goes after the value */
+            node *upper_bound(const key &key_value) {
+                node *here = root, *ans = nil;
+                while (here != nil) {
+                    if (comparator(key_value, here->key_value)) {
+                        ans = here;
+                        here = here->left;
+                    } else {
+                        here = here->right;
+                    }
                 }
+                return ans;
             }
 
             /* Find the node with the given key. It there is none return nil */
-            node *find(node *here, const key &key_value) {
+            /* The lower bound is the only candidate, so only one more comparison is needed */
+            node *find(const key &key_value) {
+                node *ans = lower_bound(key_value);
+                if (ans != nil && !comparator(key_value, ans->key_value))
+                    return ans;
+                return nil;
+            }
+
+            /* Makes the given node the left son of the parent */
+            void set_left(node *parent, node *son) {
+                parent->left = son;
+                if (son != nil)
+                    son->parent = parent;
+            }
+
+            /* Makes the given node the right son of the parent */
+            void set_right(node *parent, node *son) {
+                parent->right = son;
+                if (son != nil)
+                    son->parent = parent;
+            }
+
+            /* The result of splitting a subtree by a key */
+            struct split_result {
+                /* The subtree with the nodes that go before the key */
+                node *left;
+
+                /* The node equivalent to the key, or nil, detached from the tree */
+                node *equal;
+
+                /* The subtree with the nodes that go after the key */
+                node *right;
+            };
+
+            /* Split the subtree into the nodes that go before the key, the node equivalent to it and the nodes that go after it */
+            split_result split(node *here, const key &key_value) {
                 if (here == nil)
-                    return nil;
+                    return {nil, nil, nil};
 
-                /* First checking for equality */
-                if (!comparator(key_value, here->key_value) && !comparator(here->key_value, key_value)) {
-                    return here;
+                split_result ans;
+                if (comparator(here->key_value, key_value)) {
+                    ans = split(here->right, key_value);
+                    set_right(here, ans.left);
+                    update(here);
+                    ans.left = here;
                 } else if (comparator(key_value, here->key_value)) {
-                    return find(here->left, key_value);
+                    ans = split(here->left, key_value);
+                    set_left(here, ans.right);
+                    update(here);
+                    ans.right = here;
                 } else {
-                    return find(here->right, key_value);
+                    ans = {here->left, here, here->right};
+                    here->left = here->right = nil;
+                    update(here);
                 }
+
+                /* The two parts are roots now */
+                if (ans.left != nil)
+                    ans.left->parent = nil;
+                if (ans.right != nil)
+                    ans.right->parent = nil;
+                return ans;
             }
 
-            /* Returns the first node that does not go before the value.*/
-            /* Either it is equivalent, or goes after */
-            /* If there is no such element, return nil */
+            /* Join two subtrees, where all the nodes of the left one go before the nodes of the right one */
+            node *join(node *left, node *right) {
+                if (left == nil)
+                    return right;
+                if (right == nil)
+                    return left;
+
+                if (left->priority > right->priority) {
+                    set_right(left, join(left->right, right));
+                    update(left);
+                    return left;
+                }
+                set_left(right, join(left, right->left));
+                update(right);
+                return right;
+            }
 
-            node *lower_bound(node *here, const key &key_value) {
-                if (here == nil)
+            /* Run the two tasks, in parallel if the depth budget is not exhausted. The tasks get the remaining budget
+             * and their own list for the nodes they destroy, which is added to the given list when both are done */
+            template<class left_task, class right_task>
+            static void fork_join(unsigned depth, free_list &garbage, left_task &&left, right_task &&right) {
+                if (depth == 0) {
+                    left(0, garbage);
+                    right(0, garbage);
+                    return;
+                }
+                free_list left_garbage;
+                auto handle = std::async(std::launch::async, [&] { left(depth - 1, left_garbage); });
+                right(depth - 1, garbage);
+                handle.get();
+                garbage.splice(left_garbage);
+            }
+
+            /* Returns how many levels of the set algebra recursion should fork, for trees with the given number of nodes */
+            static unsigned parallel_depth(size_t nodes) {
+                int forced = detail::set_algebra_fork_depth.load(std::memory_order_relaxed);
+                if (forced >= 0)
+                    return static_cast<unsigned>(forced);
+                if (nodes < parallel_cutoff)
+                    return 0;
+
+                unsigned depth = 0;
+                for (unsigned threads = 1; threads < std::thread::hardware_concurrency(); threads <<= 1u)
+                    depth++;
+                return depth;
+            }
+
+            /* Returns the union of two subtrees. Duplicates are destroyed and added to the garbage */
+            node *unite(node *a, node *b, free_list &garbage, unsigned depth) {
+                if (a == nil)
+                    return b;
+                if (b == nil)
+                    return a;
+
+                /* The node with the highest priority becomes the root */
+                if (a->priority < b->priority)
+                    std::swap(a, b);
+
+                split_result parts = split(b, a->key_value);
+                node *left, *right;
+                fork_join(depth, garbage,
+                          [&](unsigned next, free_list &list) { left = unite(a->left, parts.left, list, next); },
+                          [&](unsigned next, free_list &list) { right = unite(a->right, parts.right, list, next); });
+
+                if (parts.equal != nil)
+                    destroy_node(parts.equal, garbage);
+                set_left(a, left);
+                set_right(a, right);
+                update(a);
+                return a;
+            }
+
+            /* Returns the intersection of two subtrees. The other nodes are destroyed and added to the garbage */
+            node *intersect(node *a, node *b, free_list &garbage, unsigned depth) {
+                if (a == nil || b == nil) {
+                    destroy_tree(a, garbage);
+                    destroy_tree(b, garbage);
                     return nil;
-                if (comparator(here->key_value, key_value)) {
-                    return lower_bound(here->right, key_value);
                 }
-                node *ans = lower_bound(here->left, key_value);
-                if (ans != nil)
-                    return ans;
-                return here;
+
+                if (a->priority < b->priority)
+                    std::swap(a, b);
+
+                split_result parts = split(b, a->key_value);
+                node *left, *right;
+                fork_join(depth, garbage,
+                          [&](unsigned next, free_list &list) { left = intersect(a->left, parts.left, list, next); },
+                          [&](unsigned next, free_list &list) { right = intersect(a->right, parts.right, list, next); });
+
+                if (parts.equal != nil) { // The key is in both subtrees, keep one of the nodes
+                    destroy_node(parts.equal, garbage);
+                    set_left(a, left);
+                    set_right(a, right);
+                    update(a);
+                    return a;
+                }
+                destroy_node(a, garbage);
+                return join(left, right);
             }
 
-            /* Returns the first node that goes after the value */
-            node *upper_bound(node *here, const key &key_value) {
-                if (here == nil)
+            /* Returns the nodes of the first subtree that are not in the second one. The other nodes are destroyed and added to the garbage */
+            node *subtract(node *a, node *b, free_list &garbage, unsigned depth) {
+                if (a == nil) {
+                    destroy_tree(b, garbage);
                     return nil;
+                }
+                if (b == nil)
+                    return a;
+
+                split_result parts = split(b, a->key_value);
+                node *left, *right;
+                fork_join(depth, garbage,
+                          [&](unsigned next, free_list &list) { left = subtract(a->left, parts.left, list, next); },
+                          [&](unsigned next, free_list &list) { right = subtract(a->right, parts.right, list, next); });
+
+                if (parts.equal != nil) { // The key is in the second subtree, destroy it from both
+                    destroy_node(parts.equal, garbage);
+                    destroy_node(a, garbage);
+                    return join(left, right);
+                }
+                set_left(a, left);
+                set_right(a, right);
+                update(a);
+                return a;
+            }
 
-                if (comparator(key_value, here->key_value)) {
-                    node *ans = upper_bound(here->left, key_value);
-                    if (ans != nil)
-                        return ans;
-                    return here;
+            /* Replace the content of this tree with the result of a set algebra operation between this tree and the
+             * other one. The other tree is left empty and its storage is taken over */
+            template<class operation>
+            void combine(tree &other, operation &&apply) {
+                size_t total = count + other.count;
+                free_list garbage;
+                node *here = apply(root, other.root, garbage, parallel_depth(total));
+
+                other.reset(nil, 0);
+                adopt_storage(other);
+                reset(here, total - garbage.size);
+                free_slots.splice(garbage);
+            }
+
+            /* Build the tree from a sorted range of keys in linear time. The tree must be empty */
+            template<class Iter>
+            void build(Iter first, Iter last) {
+                reserve_range(first, last);
+
+                /* The right spine of the tree built so far, from the root down */
+                std::vector<node *> spine;
+                for (; first != last; ++first) {
+                    if (!spine.empty() && !comparator(spine.back()->key_value, *first))
+                        continue; // Skip the duplicates
+
+                    node *added = create_node(*first, next_priority()), *last_popped = nil;
+
+                    /* The nodes with a smaller priority become the left subtree of the new node. Their subtrees are final */
+                    while (!spine.empty() && spine.back()->priority < added->priority) {
+                        last_popped = spine.back();
+                        spine.pop_back();
+                        update(last_popped);
+                    }
+
+                    set_left(added, last_popped);
+                    if (!spine.empty())
+                        set_right(spine.back(), added);
+                    spine.push_back(added);
+                    count++;
                 }
 
-                return upper_bound(here->right, key_value);
+                node *new_root = spine.empty() ? nil : spine.front();
+                while (!spine.empty()) {
+                    update(spine.back());
+                    spine.pop_back();
+                }
+                reset(new_root, count);
             }
 
-            tree() : count(0) {
-                nil = new node(0, 0, nullptr, nullptr, nullptr);
-                root = nil; //The root of the tree is currently nil
+            /* Replace the nodes of the tree with the given subtree */
+            void reset(node *new_root, size_t new_count) {
+                root = new_root;
+                if (root != nil)
+                    root->parent = nil;
+                count = new_count;
             }
 
+            /* Returns the number of nodes in the subtree */
+            size_t subtree_count(node *here) {
+                if (here == nil)
+                    return 0;
+                if constexpr (augmentation::counts_subtrees)
+                    return subtree_size(here);
+                return subtree_count(here->left) + subtree_count(here->right) + 1;
+            }
 
-            /* Deep-copy the tree, return the root of the tree*/
-            /* We pass the nil value of the other node to identify nil nodes */
-            node *copy(const node *here, const node *nil_marker) {
+            /* Returns the size of the subtree kept by the order_statistics augmentation */
+            template<class policy = augmentation>
+            size_t subtree_size(node *here) const {
+                static_assert(policy::counts_subtrees, "this operation needs the order_statistics augmentation");
+                return here->subtree_size;
+            }
 
-                if (here == nil_marker) {
-                    return nil;
+            /* Returns the node with the given index in the order of the set, or nil */
+            node *nth(size_t index) {
+                node *here = root;
+                while (here != nil) {
+                    size_t left_size = subtree_size(here->left);
+                    if (index == left_size)
+                        return here;
+                    if (index < left_size) {
+                        here = here->left;
+                    } else {
+                        index -= left_size + 1;
+                        here = here->right;
+                    }
+                }
+                return nil;
+            }
+
+            /* Returns the number of nodes that go before the value */
+            size_t rank(const key &key_value) {
+                node *here = root;
+                size_t ans = 0;
+                while (here != nil) {
+                    if (comparator(here->key_value, key_value)) {
+                        ans += subtree_size(here->left) + 1;
+                        here = here->right;
+                    } else {
+                        here = here->left;
+                    }
+                }
+                return ans;
+            }
+
+            /* Returns the index of the node in the order of the set, the index of nil is the number of nodes */
+            size_t index_of(node *here) {
+                if (here == nil)
+                    return count;
+
+                size_t ans = subtree_size(here->left);
+                while (here->parent != nil) {
+                    if (here == here->parent->right)
+                        ans += subtree_size(here->parent->left) + 1;
+                    here = here->parent;
+                }
+                return ans;
+            }
+
+            /* Returns the aggregate of the keys which do not go before low, but go before high */
+            auto aggregate(const key &low, const key &high) {
+                static_assert(augmentation::aggregates, "this operation needs the augmented policy");
+                using monoid = typename augmentation::monoid;
+
+                /* Find the highest node in the range, the paths to the two ends of the range split there */
+                node *here = root;
+                while (here != nil) {
+                    if (comparator(here->key_value, low)) {
+                        here = here->right;
+                    } else if (!comparator(here->key_value, high)) {
+                        here = here->left;
+                    } else {
+                        break;
+                    }
+                }
+                if (here == nil)
+                    return monoid::identity();
+
+                /* The nodes of the left subtree which do not go before low, they come in decreasing order */
+                auto left_part = monoid::identity();
+                for (node *x = here->left; x != nil;) {
+                    if (comparator(x->key_value, low)) {
+                        x = x->right;
+                    } else {
+                        left_part = monoid::combine(monoid::combine(monoid::lift(x->key_value), x->right->aggregate),
+                                                    left_part);
+                        x = x->left;
+                    }
+                }
+
+                /* The nodes of the right subtree which go before high, they come in increasing order */
+                auto right_part = monoid::identity();
+                for (node *x = here->right; x != nil;) {
+                    if (comparator(x->key_value, high)) {
+                        right_part = monoid::combine(right_part,
+                                                     monoid::combine(x->left->aggregate, monoid::lift(x->key_value)));
+                        x = x->right;
+                    } else {
+                        x = x->left;
+                    }
                 }
 
-                node *copy_node = new node(here->key_value, here->priority, nullptr, nullptr, nullptr);
-                copy_node->left = nil;
-                copy_node->right = nil;
-                copy_node->parent = nil;
+                return monoid::combine(monoid::combine(left_part, monoid::lift(here->key_value)), right_part);
+            }
+
+            tree() : nil(sentinel()), count(0), unused(nullptr), unused_end(nullptr) {
+                seed_generator();
+                root = nil; //The root of the tree is currently nil
+            }
 
-                /* Copy the left subtree */
-                node *left = copy(here->left, nil_marker);
-                copy_node->left = left;
-                if (left != nil)
-                    left->parent = copy_node;
 
-                /*Copy the right subtree */
-                node *right = copy(here->right, nil_marker);
-                copy_node->right = right;
-                if (right != nil)
-                    right->parent = copy_node;
+            /* Deep-copy the subtree, return the root of the copy. The nodes are built in preorder, without recursion,
+             * following the parent pointers of the source and of the copy */
+            /* We pass the nil value of the other node to identify nil nodes */
+            node *copy(const node *here, const node *nil_marker) {
+                if (here == nil_marker)
+                    return nil;
 
-                return copy_node;
+                node *ans = create_node(here->key_value, here->priority);
+                const node *from = here;
+                node *to = ans;
+                while (true) {
+                    if (from->left != nil_marker && to->left == nil) { // Copy the left subtree first
+                        from = from->left;
+                        to->left = create_node(from->key_value, from->priority);
+                        to->left->parent = to;
+                        to = to->left;
+                    } else if (from->right != nil_marker && to->right == nil) { // Then the right subtree
+                        from = from->right;
+                        to->right = create_node(from->key_value, from->priority);
+                        to->right->parent = to;
+                        to = to->right;
+                    } else { // Both subtrees are copied, go back up
+                        update(to);
+                        if (from == here)
+                            return ans;
+                        from = from->parent;
+                        to = to->parent;
+                    }
+                }
             }
 
-            /* Swap the tree structure with another tree structure */
+            /* Swap the tree structure with another tree structure, with its random generator and its counters */
             void swap(tree &other) {
                 std::swap(nil, other.nil);
                 std::swap(root, other.root);
                 std::swap(count, other.count);
+                blocks.swap(other.blocks);
+                std::swap(free_slots, other.free_slots);
+                std::swap(unused, other.unused);
+                std::swap(unused_end, other.unused_end);
+                std::swap(comparator, other.comparator);
+                std::swap(seed, other.seed);
+                if constexpr (statistics_policy::enabled)
+                    std::swap(this->stats, other.stats);
             }
 
-            /* Copy-construct the tree structure */
-            tree(const tree &other) : count(other.count) {
-                nil = new node(0, 0, nullptr, nullptr, nullptr);
+            /* Copy-construct the tree structure, the nodes are built in one block */
+            tree(const tree &other) : nil(sentinel()), comparator(other.comparator), count(other.count), unused(nullptr),
+                                      unused_end(nullptr) {
+                seed_generator();
+                reserve(other.count);
                 root = copy(other.root, other.nil);
             }
 
+            /* Move-construct the tree structure, taking the nodes and the blocks of the other tree */
+            tree(tree &&other) noexcept: tree() {
+                swap(other);
+            }
+
             /* Copy assignment operator */
             tree &operator=(const tree other) {
                 swap(other);
@@ -281,26 +953,67 @@ namespace dsl {
             }
 
 
-            /* Cleanup, recursively delete nodes */
-            void destroy_tree(node *here) {
-                if (here == nil)
+            /* Cleanup, recursively destroy nodes and add their slots to the garbage */
+            static void destroy_tree(node *here, free_list &garbage) {
+                if (here == sentinel())
                     return;
-                destroy_tree(here->left);
-                destroy_tree(here->right);
-
-                delete here;
+                destroy_tree(here->left, garbage);
+                destroy_tree(here->right, garbage);
+                destroy_node(here, garbage);
             }
 
-            /* Clear the container by deleting all nodes ans resetting the root to the nil pointer */
+            /* Clear the container by destroying all nodes, releasing the blocks and resetting the root to the nil pointer */
             void clear() {
-                destroy_tree(root);
+                if (!std::is_trivially_destructible<node>::value) // Otherwise the blocks are released without visiting the nodes
+                    destroy_tree(root, free_slots);
                 root = nil;
                 count = 0;
+
+                blocks.clear();
+                free_slots = free_list();
+                unused = unused_end = nullptr;
             }
 
             ~tree() {
                 clear();
-                delete nil;// Don't forget to delete the nil node
+            }
+
+            /* The number of bytes used by the storage of the nodes. Slots of shared blocks that hold nodes of other trees are not counted */
+            size_t storage_usage() const {
+                size_t slots = count + free_slots.size + static_cast<size_t>(unused_end - unused);
+                return slots * sizeof(slot) + blocks.capacity() * sizeof(std::shared_ptr<slot>);
+            }
+
+            /* Returns the number of nodes at every depth */
+            std::vector<size_t> depths() const {
+                std::vector<size_t> ans;
+                std::vector<std::pair<const node *, size_t>> stack;
+                if (root != nil)
+                    stack.emplace_back(root, 0);
+
+                while (!stack.empty()) {
+                    const node *here = stack.back().first;
+                    size_t depth = stack.back().second;
+                    stack.pop_back();
+
+                    if (depth >= ans.size())
+                        ans.resize(depth + 1);
+                    ans[depth]++;
+                    if (here->left != nil)
+                        stack.emplace_back(here->left, depth + 1);
+                    if (here->right != nil)
+                        stack.emplace_back(here->right, depth + 1);
+                }
+                return ans;
+            }
+
+            /* Appends the nodes of the subtree that are less than the given depth deep, in order */
+            void top_nodes(node *here, unsigned depth, std::vector<node *> &out) {
+                if (here == nil || depth == 0)
+                    return;
+                top_nodes(here->left, depth - 1, out);
+                out.push_back(here);
+                top_nodes(here->right, depth - 1, out);
             }
         };
 
@@ -383,24 +1096,148 @@ namespace dsl {
             tree *h_structure;//a reference to the tree structure
         };
 
-        /** Copy constructor, make a copy of the other set. */
+        /** A sequence of consecutive elements of the set, that can be traversed independently of the others. */
+        struct range {
+            iterator first, last;
+
+            /** Returns an iterator to the first element of the range. */
+            iterator begin() const {
+                return first;
+            }
+
+            /** Returns an iterator past the last element of the range. */
+            iterator end() const {
+                return last;
+            }
+        };
+
+        /**
+         * Splits the set into consecutive ranges, for parallel traversal, see dsl/parallel.h.
+         *
+         * The nodes in the top levels of the tree, starting with the root and its children, are the borders
+         * of the ranges, so each range is one subtree under these levels followed by one of their nodes.
+         * It returns at most the smallest power of two that is at least parts ranges, none of them empty.
+         * Their sizes are balanced only on average. Modifying the set invalidates the ranges.
+         */
+        std::vector<range> ranges(size_t parts) {
+            unsigned depth = 0;
+            while ((size_t(1) << depth) < parts)
+                depth++;
+
+            std::vector<node *> borders;
+            structure.top_nodes(structure.root, depth, borders);
+
+            std::vector<range> ans;
+            iterator first = begin();
+            for (node *border : borders) {
+                iterator last(border, &structure);
+                if (first != last)
+                    ans.push_back({first, last});
+                first = last;
+            }
+            if (first != end())
+                ans.push_back({first, end()});
+            return ans;
+        }
+
+        /** Copy constructor, make a copy of the other set. The nodes of the copy are built in one block. */
         set(const set &other) : structure(other.structure) {
 
         }
 
-        /** Assigns new contents to the set, replacing its current contents.*/
-        set &operator=(set other) {
+        /**
+         * Move constructor, takes the elements of the other set in constant time. The other set is left empty.
+         * The iterators of the other set are invalidated, they refer to the set object they were created from.
+         */
+        set(set &&other) noexcept: structure(std::move(other.structure)) {
+
+        }
+
+        /** Assigns new contents to the set, replacing its current contents. Assigning from an rvalue takes its
+         * elements in constant time. Invalidates the iterators of this set. */
+        set &operator=(set other) noexcept {
             swap(other);
             return *this;
         }
 
-        /** Swaps the content of this set with another set.*/
+        /** Swaps the content of this set with another set, with the statistics counters. Invalidates the iterators of both sets. */
         void swap(set &other) {
             structure.swap(other.structure);
         }
 
         set() = default;
 
+        /**
+         * Constructs the set from a range of keys sorted in the order of the set, in linear time.
+         *
+         * Equivalent consecutive keys are inserted once. The nodes are built in one contiguous block, unless the range
+         * is read through input iterators. Only iterators are taken, so set(1, 2) does not compile.
+         */
+        template<class Iter, class = typename std::iterator_traits<Iter>::iterator_category>
+        set(Iter sorted_first, Iter sorted_last) {
+            structure.build(sorted_first, sorted_last);
+        }
+
+        /**
+         * Replaces the content of the set with a range of keys sorted in the order of the set, in linear time.
+         */
+        template<class Iter, class = typename std::iterator_traits<Iter>::iterator_category>
+        void assign(Iter sorted_first, Iter sorted_last) {
+            structure.clear();
+            structure.build(sorted_first, sorted_last);
+        }
+
+        /**
+         * Inserts a range of keys sorted in the order of the set.
+         *
+         * Every search starts from the node of the previous key, going up only as far as needed, so for k keys spread
+         * over a set of n elements this takes O(k log(n/k + 1)) instead of the O(k log n) of k calls to insert.
+         * The new nodes are built in one block, unless the range is read through input iterators.
+         */
+        template<class Iter, class = typename std::iterator_traits<Iter>::iterator_category>
+        void insert_sorted_range(Iter sorted_first, Iter sorted_last) {
+            structure.reserve_range(sorted_first, sorted_last);
+
+            node *finger = structure.nil;
+            for (; sorted_first != sorted_last; ++sorted_first) {
+                node *start = finger == structure.nil ? structure.root : structure.climb(finger, *sorted_first);
+                finger = structure.insert(start, *sorted_first);
+            }
+        }
+
+        /**
+         * Finds a range of keys sorted in the order of the set, writing an iterator to each of them to the output, or
+         * the end iterator if the key is not in the set.
+         *
+         * Every search continues from the result of the previous key, going up only as far as needed, so for k keys
+         * spread over a set of n elements this takes O(k log(n/k + 1)) instead of the O(k log n) of k calls to find.
+         * @return The output iterator after the last written iterator.
+         */
+        template<class Iter, class Out>
+        Out find_many(Iter sorted_first, Iter sorted_last, Out result) {
+            node *finger = structure.root == structure.nil ? structure.nil : structure.tree_minimum(structure.root);
+            for (; sorted_first != sorted_last; ++sorted_first, ++result) {
+                finger = structure.lower_bound_from(finger, *sorted_first);
+                bool found = finger != structure.nil && !structure.comparator(*sorted_first, finger->key_value);
+                *result = iterator(found ? finger : structure.nil, &structure);
+            }
+            return result;
+        }
+
+        /**
+         * Same as find_many, but write the lower bound of every key in the range.
+         * @return The output iterator after the last written iterator.
+         */
+        template<class Iter, class Out>
+        Out lower_bound_many(Iter sorted_first, Iter sorted_last, Out result) {
+            node *finger = structure.root == structure.nil ? structure.nil : structure.tree_minimum(structure.root);
+            for (; sorted_first != sorted_last; ++sorted_first, ++result) {
+                finger = structure.lower_bound_from(finger, *sorted_first);
+                *result = iterator(finger, &structure);
+            }
+            return result;
+        }
+
         /** Returns an iterator to the first element in the set. */
         iterator begin() {
             if (structure.root == structure.nil) // If the root is nil, return nil
@@ -416,27 +1253,27 @@ namespace dsl {
 
         /** Insert a new entry with the given key value. **/
         void insert(const key &key_value) {
-            structure.insert(structure.root, structure.nil, key_value);
+            structure.insert(structure.root, key_value);
         }
 
         /** Returns an iterator that points to the element with the given key. If no element with the given key is found in the set, return the end iterator. */
         iterator find(const key &key_value) {
-            return iterator(structure.find(structure.root, key_value), &structure);
+            return iterator(structure.find(key_value), &structure);
         }
 
         /** Returns an iterator to the first element which is not considered to go before the given value. */
         iterator lower_bound(const key &value) {
-            return iterator(structure.lower_bound(structure.root, value), &structure);
+            return iterator(structure.lower_bound(value), &structure);
         }
 
         /** Returns an iterator to the first element which is considered to go after the given value. */
         iterator upper_bound(const key &value) {
-            return iterator(structure.upper_bound(structure.root, value), &structure);
+            return iterator(structure.upper_bound(value), &structure);
         }
 
         /** Removes an element from the set by iterator. */
         void erase(iterator to_erase) {
-            structure.erase(structure.root, to_erase.h_node);
+            structure.erase(to_erase.h_node);
         }
 
         /** Returns the number of elements in the set. */
@@ -454,6 +1291,193 @@ namespace dsl {
             structure.clear();
         }
 
+        /**
+         * Returns the number of bytes used by the set and its nodes, including the free slots kept for reuse.
+         * After split or the set algebra, the slots of shared blocks that hold nodes of the other set are not counted.
+         */
+        size_t memory_usage() const {
+            return sizeof(*this) + structure.storage_usage();
+        }
+
+        /** Makes room for the given number of elements, so that the next inserts build their nodes in one block. */
+        void reserve(size_t elements) {
+            if (elements > structure.count)
+                structure.reserve(elements - structure.count);
+        }
+
+        /** Rebuilds the nodes in one block of exactly the size of the set, releasing the free slots. Invalidates the iterators. */
+        void shrink_to_fit() {
+            tree compact(structure);
+            if constexpr (statistics_policy::enabled)
+                compact.stats = structure.stats;
+            structure.swap(compact);
+        }
+
+        /** Returns the depth distribution of the nodes, and the rotations per insert when the statistics are collected. */
+        set_statistics statistics() const {
+            set_statistics ans;
+            ans.depths = structure.depths();
+
+            size_t total = 0;
+            for (size_t depth = 0; depth < ans.depths.size(); depth++)
+                total += depth * ans.depths[depth];
+            if (structure.count > 0)
+                ans.average_depth = static_cast<double>(total) / structure.count;
+
+            if constexpr (statistics_policy::enabled) {
+                ans.inserts = structure.stats.inserts;
+                if (structure.stats.inserts > 0)
+                    ans.rotations_per_insert = static_cast<double>(structure.stats.rotations) / structure.stats.inserts;
+            }
+            return ans;
+        }
+
+        /**
+         * Returns an iterator to the element with the given index in the order of the set, or the end iterator if the
+         * index is not smaller than the size. Needs the order_statistics augmentation, it takes O(log n).
+         */
+        iterator nth(size_t index) {
+            return iterator(structure.nth(index), &structure);
+        }
+
+        /**
+         * Returns the number of elements which are considered to go before the given value.
+         * Needs the order_statistics augmentation, it takes O(log n).
+         */
+        size_t rank(const key &value) {
+            return structure.rank(value);
+        }
+
+        /**
+         * Returns the number of elements which are not considered to go before low, but go before high.
+         * Needs the order_statistics augmentation, it takes O(log n).
+         */
+        size_t count_range(const key &low, const key &high) {
+            size_t before_high = structure.rank(high), before_low = structure.rank(low);
+            return before_high > before_low ? before_high - before_low : 0;
+        }
+
+        /**
+         * Returns the aggregate of the elements which are not considered to go before low, but go before high.
+         * Needs the augmented policy, it takes O(log n).
+         */
+        auto aggregate(const key &low, const key &high) {
+            return structure.aggregate(low, high);
+        }
+
+        /**
+         * Returns the aggregate of all the elements in O(1). Needs the augmented policy.
+         */
+        auto aggregate() const {
+            static_assert(augmentation::aggregates, "this operation needs the augmented policy");
+            return structure.root->aggregate;
+        }
+
+        /**
+         * Returns the number of increments needed to go from first to last.
+         * Needs the order_statistics augmentation, it takes O(log n).
+         */
+        size_t distance(iterator first, iterator last) {
+            return structure.index_of(last.h_node) - structure.index_of(first.h_node);
+        }
+
+        /**
+         * Removes the elements which are not considered to go before the given key and returns them as a new set.
+         *
+         * Splitting takes O(log n). Counting the elements of the new set takes linear time in its size, or O(1) with
+         * the order_statistics augmentation.
+         */
+        set split(const key &key_value) {
+            auto parts = structure.split(structure.root, key_value);
+
+            set after;
+            after.structure.blocks = structure.blocks; // The blocks are shared by the two sets
+            after.structure.reset(structure.join(parts.equal, parts.right), 0);
+            after.structure.count = after.structure.subtree_count(after.structure.root);
+
+            structure.reset(parts.left, structure.count - after.structure.count);
+            return after;
+        }
+
+        /**
+         * Moves all the elements of the other set to the end of this set, leaving the other set empty.
+         *
+         * All the elements of the other set must go after the elements of this set. Takes O(log n).
+         */
+        void join(set &other) {
+            if (&other == this)
+                return;
+            structure.reset(structure.join(structure.root, other.structure.root),
+                            structure.count + other.structure.count);
+            other.structure.reset(other.structure.nil, 0);
+            structure.adopt_storage(other.structure);
+        }
+
+        /** Removes the elements in the range [first,last). */
+        void erase_range(iterator first, iterator last) {
+            if (first == last)
+                return;
+
+            auto before = structure.split(structure.root, *first);
+            node *middle = structure.join(before.equal, before.right), *after = structure.nil;
+
+            if (last != end()) {
+                auto parts = structure.split(middle, *last);
+                middle = parts.left;
+                after = structure.join(parts.equal, parts.right);
+            }
+
+            free_list garbage;
+            tree::destroy_tree(middle, garbage);
+            structure.reset(structure.join(before.left, after), structure.count - garbage.size);
+            structure.free_slots.splice(garbage);
+        }
+
+        /**
+         * Replaces the content of the set with the union of this set and the other set, leaving the other set empty.
+         *
+         * The nodes of both sets are reused. It takes O(m log(n/m + 1)) work for sets of sizes m <= n, and the recursion
+         * runs in parallel for large sets.
+         */
+        void set_union(set &other) {
+            if (&other == this)
+                return;
+
+            structure.combine(other.structure, [this](node *a, node *b, free_list &garbage, unsigned depth) {
+                return structure.unite(a, b, garbage, depth);
+            });
+        }
+
+        /**
+         * Replaces the content of the set with the intersection of this set and the other set, leaving the other set empty.
+         *
+         * It has the same complexity as set_union.
+         */
+        void set_intersection(set &other) {
+            if (&other == this)
+                return;
+
+            structure.combine(other.structure, [this](node *a, node *b, free_list &garbage, unsigned depth) {
+                return structure.intersect(a, b, garbage, depth);
+            });
+        }
+
+        /**
+         * Removes from this set the elements of the other set, leaving the other set empty.
+         *
+         * It has the same complexity as set_union.
+         */
+        void set_difference(set &other) {
+            if (&other == this) {
+                clear();
+                return;
+            }
+
+            structure.combine(other.structure, [this](node *a, node *b, free_list &garbage, unsigned depth) {
+                return structure.subtract(a, b, garbage, depth);
+            });
+        }
+
     };
 }
 
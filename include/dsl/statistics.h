@@ -0,0 +1,117 @@
+//
+// Created by gvisan on 18.10.2026.
+//
+
+#ifndef DSL_STATISTICS_H
+#define DSL_STATISTICS_H
+
+#include<cstddef> //for size_t
+#include<vector>
+
+namespace dsl {
+
+    /**
+     * The default statistics policy of the containers: nothing is counted.
+     *
+     * The counters are not stored and the code that updates them is not compiled, so a container with this policy
+     * has the same size and speed as if the statistics did not exist.
+     */
+    struct no_statistics {
+        /** Whether the containers count their operations. */
+        static constexpr bool enabled = false;
+
+        /** The base class that holds the counters of a container. It is empty. */
+        template<class counters>
+        struct storage {
+        };
+    };
+
+    /**
+     * A statistics policy that makes the containers count their operations: probes, rotations, sifts or allocations.
+     * The counters are reported by the statistics() method of each container, next to the numbers that are computed
+     * from the structure itself and are reported with any policy.
+     */
+    struct collect_statistics {
+        /** Whether the containers count their operations. */
+        static constexpr bool enabled = true;
+
+        /** The base class that holds the counters of a container. */
+        template<class counters>
+        struct storage {
+            counters stats;
+        };
+    };
+
+    /** The statistics reported by dsl::hashmap. */
+    struct hashmap_statistics {
+        /** bucket_lengths[i] is the number of buckets that hold i elements. */
+        std::vector<size_t> bucket_lengths;
+
+        /** The number of calls to find and insert. Only counted with collect_statistics. */
+        size_t lookups = 0;
+
+        /** The average number of keys compared by a find or an insert. Only counted with collect_statistics. */
+        double average_probe_length = 0;
+    };
+
+    /** The statistics reported by dsl::set. */
+    struct set_statistics {
+        /** depths[d] is the number of nodes at depth d. The root is at depth 0. */
+        std::vector<size_t> depths;
+
+        /** The average depth of a node. */
+        double average_depth = 0;
+
+        /** The number of keys added by insert. Only counted with collect_statistics. */
+        size_t inserts = 0;
+
+        /** The average number of rotations done by these inserts. Only counted with collect_statistics. */
+        double rotations_per_insert = 0;
+    };
+
+    /** The statistics reported by dsl::heap. */
+    struct heap_statistics {
+        /** The number of calls to push and pop. Only counted with collect_statistics. */
+        size_t sifts = 0;
+
+        /** The average number of levels an element moved during push or pop. Only counted with collect_statistics. */
+        double average_sift_depth = 0;
+
+        /** The largest number of levels an element moved. Only counted with collect_statistics. */
+        size_t max_sift_depth = 0;
+    };
+
+    /** The statistics reported by dsl::list. */
+    struct list_statistics {
+        /** The number of nodes kept for reuse after reserve, released by shrink_to_fit. */
+        size_t spare_nodes = 0;
+
+        /** The number of nodes allocated from the heap. Only counted with collect_statistics. */
+        size_t allocations = 0;
+
+        /** The number of nodes taken from the spare nodes instead. Only counted with collect_statistics. */
+        size_t reuses = 0;
+    };
+
+    namespace detail {
+        /* The counters kept by each container when the statistics are enabled */
+
+        struct hashmap_counters {
+            size_t lookups = 0, probes = 0;
+        };
+
+        struct set_counters {
+            size_t inserts = 0, rotations = 0;
+        };
+
+        struct heap_counters {
+            size_t sifts = 0, levels = 0, max_levels = 0;
+        };
+
+        struct list_counters {
+            size_t allocations = 0, reuses = 0;
+        };
+    }
+}
+
+#endif //DSL_STATISTICS_H
@@ -0,0 +1,195 @@
+//
+// Created by gvisan on 18.10.2026.
+//
+
+#ifndef DSL_TOPK_H
+#define DSL_TOPK_H
+
+#include<algorithm> //for sort
+#include<array>
+#include<cstddef> //for size_t
+#include<functional> //for less, greater
+#include<iterator> //for distance, iterator_traits
+#include<type_traits> //for is_arithmetic, is_same
+#include<utility> //for swap
+#include<vector>
+
+namespace dsl {
+
+    /**
+     * Keeps the best K elements of a stream, in a heap of fixed capacity.
+     *
+     * The best elements are the ones a dsl::heap with the same comparator would return first, the greatest ones for
+     * std::less. The root of the heap is the worst element kept, the threshold a new element has to beat, so most
+     * elements of a long stream are rejected with one comparison. Pushing a range of arithmetic values ordered by
+     * std::less or std::greater compares them against the threshold in blocks, with a loop the compiler vectorizes.
+     *
+     * @tparam type The type of the elements.
+     * @tparam compare A binary predicate that defines a strict weak ordering.\n The expression compare(a,b) shall return true if a is considered to go before b, so b is the better one.
+     * @tparam K The number of elements kept.
+     */
+    template<class type, class compare=std::less<type>, size_t K = 16>
+    class topk {
+        static_assert(K > 0, "topk must keep at least one element");
+
+    private:
+
+        /* The heap, data[1] is the root. The parent of every element is worse than the element */
+        std::array<type, K + 1> data{};
+
+        /* The number of elements kept */
+        size_t count;
+
+        compare comparator;
+
+        /* Elements pushed as a range are compared against the threshold this many at a time */
+        static constexpr size_t block = 64;
+
+        /* Whether comparing a block against the threshold vectorizes */
+        static constexpr bool block_filter = std::is_arithmetic<type>::value &&
+                                             (std::is_same<compare, std::less<type>>::value ||
+                                              std::is_same<compare, std::greater<type>>::value);
+
+        /* Returns the index of the left son of the node */
+        static size_t left_son(size_t node) {
+            return node << 1u;
+        }
+
+        /* Returns the index of the father of the node */
+        static size_t father(size_t node) {
+            return node >> 1u;
+        }
+
+        /* Moves the node down the heap, while one of its sons is worse */
+        void shift(size_t node) {
+            while (left_son(node) <= count) {
+                size_t worst = left_son(node);
+                if (worst + 1 <= count && comparator(data[worst + 1], data[worst]))
+                    worst++;
+
+                if (!comparator(data[worst], data[node]))
+                    return;
+                std::swap(data[node], data[worst]);
+                node = worst;
+            }
+        }
+
+        /* Moves the node up the heap, while it is worse than its father */
+        void percolate(size_t node) {
+            while (father(node) != 0 && comparator(data[node], data[father(node)])) {
+                std::swap(data[node], data[father(node)]);
+                node = father(node);
+            }
+        }
+
+        /* Adds the value to a full heap, if it is better than the threshold */
+        void offer(const type &value) {
+            if (comparator(data[1], value)) {
+                data[1] = value;
+                shift(1);
+            }
+        }
+
+        /* Returns whether some of the n values beats the threshold */
+        bool any_wins(const type *values, size_t n) const {
+            const type bound = data[1]; // A local copy, so the loop does not reload it
+            const compare order = comparator;
+            unsigned ans = 0;
+            for (size_t i = 0; i < n; i++)
+                ans |= order(bound, values[i]);
+            return ans != 0;
+        }
+
+        /* Pushes n values stored one after another */
+        void push_contiguous(const type *values, size_t n) {
+            while (n > 0 && count < K) {
+                push(*values++);
+                n--;
+            }
+
+            for (; n >= block; values += block, n -= block)
+                if (any_wins(values, block))
+                    for (size_t i = 0; i < block; i++)
+                        offer(values[i]);
+
+            for (size_t i = 0; i < n; i++)
+                offer(values[i]);
+        }
+
+    public:
+
+        topk() : count(0) {
+
+        }
+
+        /** Adds the value, if fewer than K elements are kept or the value is better than the threshold. */
+        void push(const type &value) {
+            if (count < K) {
+                data[++count] = value;
+                percolate(count);
+            } else {
+                offer(value);
+            }
+        }
+
+        /**
+         * Pushes every value of the range.
+         *
+         * Ranges of pointers or std::vector iterators over arithmetic values, ordered by std::less or std::greater,
+         * are compared against the threshold in blocks, and only the blocks that hold a better value are pushed one
+         * by one. This overload only takes iterators, so push(a, b) with two values does not compile.
+         */
+        template<class Iter, class = typename std::iterator_traits<Iter>::iterator_category>
+        void push(Iter first, Iter last) {
+            constexpr bool contiguous = std::is_same<Iter, type *>::value || std::is_same<Iter, const type *>::value ||
+                                        std::is_same<Iter, typename std::vector<type>::iterator>::value ||
+                                        std::is_same<Iter, typename std::vector<type>::const_iterator>::value;
+            if constexpr (block_filter && contiguous) {
+                if (first != last)
+                    push_contiguous(&*first, static_cast<size_t>(std::distance(first, last)));
+            } else {
+                for (; first != last; first++)
+                    push(*first);
+            }
+        }
+
+        /**
+         * Returns the worst element kept, the one a new element has to beat once K elements are kept.
+         *
+         * Calling this function when no element is kept results in undefined behaviour.
+         */
+        const type &threshold() const {
+            return data[1];
+        }
+
+        /** Returns the elements kept, from the best to the worst. */
+        std::vector<type> sorted() const {
+            std::vector<type> ans(data.begin() + 1, data.begin() + 1 + count);
+            const compare order = comparator;
+            std::sort(ans.begin(), ans.end(), [&order](const type &a, const type &b) { return order(b, a); });
+            return ans;
+        }
+
+        /** Returns the number of elements kept. */
+        size_t size() const {
+            return count;
+        }
+
+        /** Checks if no element is kept. */
+        bool empty() const {
+            return count == 0;
+        }
+
+        /** Returns the number of elements that can be kept, K. */
+        static constexpr size_t capacity() {
+            return K;
+        }
+
+        /** Removes all the elements. */
+        void clear() {
+            count = 0;
+        }
+    };
+}
+
+#endif //DSL_TOPK_H
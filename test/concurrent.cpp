@@ -0,0 +1,204 @@
+//
+// Created by gvisan on 18.10.2026.
+//
+
+#include<atomic>
+#include<set>
+#include<thread>
+#include<vector>
+#include<dsl/concurrent_set.h>
+#include"test.h"
+
+namespace dsl_test {
+    namespace {
+
+        using key = int;
+
+        constexpr int thread_count = 4;
+
+        /* Each thread works on the keys equal to its index modulo thread_count, so it knows exactly which of them are
+         * in the set, while the other threads insert and erase the nodes around them */
+        void test_stress() {
+            dsl::concurrent_set<key> structure;
+            std::atomic<bool> valid(true);
+            std::vector<std::set<key>> owned(thread_count);
+            std::vector<std::thread> threads;
+
+            for (int t = 0; t < thread_count; t++) {
+                threads.emplace_back([&, t] {
+                    xorshift generator(static_cast<uint64_t>(t) + 20);
+                    std::set<key> &expected = owned[static_cast<size_t>(t)];
+                    for (int i = 0; i < 100000; i++) {
+                        key value = generator.below(2000) * thread_count + t;
+                        bool present = expected.count(value) != 0;
+                        switch (generator.below(4)) {
+                            case 0:
+                                if (structure.insert(value) == present)
+                                    valid = false;
+                                expected.insert(value);
+                                break;
+                            case 1:
+                                if (structure.erase(value) != present)
+                                    valid = false;
+                                expected.erase(value);
+                                break;
+                            case 2:
+                                if (structure.erase(structure.find(value)) != present)
+                                    valid = false;
+                                expected.erase(value);
+                                break;
+                            default: {
+                                auto position = structure.find(value);
+                                if ((position != structure.end()) != present ||
+                                    (present && *position != value))
+                                    valid = false;
+                            }
+                        }
+                    }
+                });
+            }
+            for (std::thread &worker : threads)
+                worker.join();
+            DSL_CHECK(valid);
+
+            std::set<key> expected;
+            for (const std::set<key> &keys : owned)
+                expected.insert(keys.begin(), keys.end());
+            DSL_CHECK(structure.size() == expected.size());
+            DSL_CHECK(std::vector<key>(structure.begin(), structure.end()) ==
+                      std::vector<key>(expected.begin(), expected.end()));
+        }
+
+        /* Lets a fixed number of threads wait for each other */
+        class barrier {
+        public:
+            explicit barrier(int threads) : total(threads) {
+
+            }
+
+            void wait() {
+                int current = generation.load();
+                if (waiting.fetch_add(1) + 1 == total) {
+                    waiting = 0;
+                    generation++;
+                } else {
+                    while (generation.load() == current)
+                        std::this_thread::yield();
+                }
+            }
+
+        private:
+            std::atomic<int> waiting{0}, generation{0};
+            const int total;
+        };
+
+        /* All the threads insert, erase and find the same few keys. For every key, the successful inserts and erases
+         * must alternate: whenever the threads stop, the inserts minus the erases is 1 if the key is in the set and 0
+         * otherwise, and it never goes outside of that */
+        void test_shared_keys() {
+            constexpr int keys = 32, rounds = 200, operations = 500;
+            dsl::concurrent_set<key> structure;
+            std::atomic<long> balance[keys] = {};
+            std::atomic<bool> valid(true);
+            barrier stopped(thread_count), resumed(thread_count);
+
+            /* Run by the first thread while the others wait */
+            auto check = [&] {
+                long total = 0;
+                for (key value = 0; value < keys; value++) {
+                    long inserted = balance[value].load();
+                    bool present = structure.find(value) != structure.end();
+                    if (inserted != (present ? 1 : 0))
+                        valid = false;
+                    total += inserted;
+                }
+                if (structure.size() != static_cast<size_t>(total))
+                    valid = false;
+            };
+
+            std::vector<std::thread> threads;
+            for (int t = 0; t < thread_count; t++) {
+                threads.emplace_back([&, t] {
+                    xorshift generator(static_cast<uint64_t>(t) + 40);
+                    for (int round = 0; round < rounds; round++) {
+                        for (int i = 0; i < operations; i++) {
+                            key value = generator.below(keys);
+                            switch (generator.below(4)) {
+                                case 0:
+                                    balance[value] += structure.insert(value);
+                                    break;
+                                case 1:
+                                    balance[value] -= structure.erase(value);
+                                    break;
+                                case 2:
+                                    balance[value] -= structure.erase(structure.find(value));
+                                    break;
+                                default: {
+                                    auto position = structure.find(value);
+                                    if (position != structure.end() && *position != value)
+                                        valid = false;
+                                }
+                            }
+                        }
+                        stopped.wait();
+                        if (t == 0)
+                            check();
+                        resumed.wait();
+                    }
+                });
+            }
+            for (std::thread &worker : threads)
+                worker.join();
+            DSL_CHECK(valid);
+        }
+
+        /* All the threads erase the same keys through iterators, each key must be erased exactly once */
+        void test_contended_erase() {
+            dsl::concurrent_set<key> structure;
+            for (key value = 0; value < 20000; value++)
+                structure.insert(value);
+
+            std::atomic<size_t> erased(0);
+            std::vector<std::thread> threads;
+            for (int t = 0; t < thread_count; t++) {
+                threads.emplace_back([&, t] {
+                    xorshift generator(static_cast<uint64_t>(t) + 30);
+                    size_t mine = 0;
+                    for (int i = 0; i < 40000; i++)
+                        mine += structure.erase(structure.find(generator.below(20000)));
+                    for (key value = 0; value < 20000; value++)
+                        mine += structure.erase(structure.find(value));
+                    erased += mine;
+                });
+            }
+            for (std::thread &worker : threads)
+                worker.join();
+
+            DSL_CHECK(erased == 20000);
+            DSL_CHECK(structure.empty() && structure.begin() == structure.end());
+        }
+
+        /* An iterator to an erased element does not erase a newer element with the same key */
+        void test_stale_iterator() {
+            dsl::concurrent_set<key> structure;
+            structure.insert(5);
+            structure.insert(7);
+
+            auto stale = structure.find(5);
+            DSL_CHECK(structure.erase(5));
+            DSL_CHECK(structure.insert(5));
+            DSL_CHECK(!structure.erase(stale));
+            DSL_CHECK(structure.find(5) != structure.end() && structure.size() == 2);
+
+            DSL_CHECK(!structure.erase(structure.end()));
+            DSL_CHECK(structure.erase(structure.find(5)) && structure.size() == 1);
+        }
+    }
+
+    void register_concurrent(registry &tests) {
+        tests.push_back({"concurrent/dsl::concurrent_set/stress", test_stress});
+        tests.push_back({"concurrent/dsl::concurrent_set/shared_keys", test_shared_keys});
+        tests.push_back({"concurrent/dsl::concurrent_set/contended_erase", test_contended_erase});
+        tests.push_back({"concurrent/dsl::concurrent_set/stale_iterator", test_stale_iterator});
+    }
+}
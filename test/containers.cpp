@@ -0,0 +1,272 @@
+//
+// Created by gvisan on 18.10.2026.
+//
+
+#include<algorithm> //for sort
+#include<atomic>
+#include<functional> //for greater
+#include<list>
+#include<queue> //for priority_queue
+#include<string>
+#include<type_traits> //for void_t, false_type
+#include<unordered_map>
+#include<utility> //for move, declval
+#include<vector>
+#include<dsl/hashmap.h>
+#include<dsl/heap.h>
+#include<dsl/list.h>
+#include<dsl/parallel.h>
+#include<dsl/set.h>
+#include<dsl/topk.h>
+#include"test.h"
+
+namespace dsl_test {
+    namespace {
+
+        /* Checks that the map holds exactly the expected elements */
+        template<class map>
+        void check_same(map &structure, const std::unordered_map<int, int> &expected) {
+            DSL_CHECK(structure.size() == expected.size());
+            size_t seen = 0;
+            for (auto &element : structure) {
+                auto position = expected.find(element.first);
+                DSL_CHECK(position != expected.end() && position->second == element.second);
+                seen++;
+            }
+            DSL_CHECK(seen == expected.size());
+        }
+
+        void test_hashmap() {
+            xorshift generator(1);
+            dsl::hashmap<int, int, std::hash<int>, std::equal_to<int>, dsl::collect_statistics> structure(64);
+            std::unordered_map<int, int> expected;
+
+            for (int i = 0; i < 100000; i++) {
+                int value = generator.below(5000);
+                if (generator.below(3) == 0) {
+                    auto position = structure.find(value);
+                    DSL_CHECK((position == structure.end()) == (expected.count(value) == 0));
+                    if (position != structure.end()) {
+                        structure.erase(position);
+                        expected.erase(value);
+                    }
+                } else {
+                    structure.insert({value, i});
+                    expected.insert({value, i});
+                }
+                if (i == 50000) {
+                    structure.reserve(10000);
+                    check_same(structure, expected);
+                }
+            }
+            check_same(structure, expected);
+
+            structure.shrink_to_fit();
+            check_same(structure, expected);
+
+            dsl::hashmap_statistics report = structure.statistics();
+            size_t elements = 0;
+            for (size_t length = 0; length < report.bucket_lengths.size(); length++)
+                elements += length * report.bucket_lengths[length];
+            DSL_CHECK(elements == expected.size());
+            DSL_CHECK(report.lookups > 0);
+
+            size_t in_ranges = 0;
+            for (auto &range : structure.ranges(7))
+                for (auto &element : range)
+                    in_ranges += expected.count(element.first);
+            DSL_CHECK(in_ranges == expected.size());
+        }
+
+        void test_heap() {
+            xorshift generator(2);
+            dsl::heap<int> structure;
+            std::priority_queue<int> expected;
+
+            for (int i = 0; i < 100000; i++) {
+                if (generator.below(3) == 0 && !expected.empty()) {
+                    DSL_CHECK(structure.top() == expected.top());
+                    structure.pop();
+                    expected.pop();
+                } else {
+                    int value = generator.below(100000);
+                    structure.push(value);
+                    expected.push(value);
+                }
+                DSL_CHECK(structure.size() == expected.size());
+            }
+            while (!expected.empty()) {
+                DSL_CHECK(structure.top() == expected.top());
+                structure.pop();
+                expected.pop();
+            }
+            DSL_CHECK(structure.empty());
+
+            std::vector<int> values;
+            for (int i = 0; i < 1000; i++)
+                values.push_back(generator.below(500));
+            dsl::heap<int, std::greater<int>> built(values.begin(), values.end());
+            std::sort(values.begin(), values.end());
+            for (int value : values) {
+                DSL_CHECK(built.top() == value);
+                built.pop();
+            }
+        }
+
+        void test_list() {
+            xorshift generator(3);
+            dsl::list<std::string> structure;
+            std::list<std::string> expected;
+
+            for (int i = 0; i < 20000; i++) {
+                size_t index = expected.empty() ? 0 : static_cast<size_t>(generator.below(static_cast<int>(expected.size())));
+                auto position = structure.begin();
+                auto expected_position = expected.begin();
+                std::advance(position, index);
+                std::advance(expected_position, index);
+
+                if (generator.below(3) == 0 && !expected.empty()) {
+                    structure.erase(position);
+                    expected.erase(expected_position);
+                } else {
+                    std::string value = "element-" + std::to_string(i) + "-with-a-long-suffix";
+                    structure.insert(position, value);
+                    expected.insert(expected_position, value);
+                }
+                if (expected.size() > 200) {
+                    structure.erase(structure.begin());
+                    expected.pop_front();
+                }
+            }
+            DSL_CHECK(structure.size() == expected.size());
+            DSL_CHECK(std::vector<std::string>(structure.begin(), structure.end()) ==
+                      std::vector<std::string>(expected.begin(), expected.end()));
+
+            dsl::list<std::string> copy(structure);
+            structure.clear();
+            DSL_CHECK(structure.empty() && structure.begin() == structure.end());
+            DSL_CHECK(std::vector<std::string>(copy.begin(), copy.end()) ==
+                      std::vector<std::string>(expected.begin(), expected.end()));
+
+            dsl::list<std::string> moved(std::move(copy));
+            DSL_CHECK(moved.size() == expected.size());
+
+            /* A moved-from list is empty and can be copied and used again */
+            DSL_CHECK(copy.empty() && copy.size() == 0 && copy.begin() == copy.end());
+            dsl::list<std::string> copy_of_moved(copy);
+            DSL_CHECK(copy_of_moved.empty());
+            copy.insert(copy.end(), "b");
+            copy.insert(copy.begin(), "a");
+            DSL_CHECK(copy.size() == 2 && copy.front() == "a" && copy.back() == "b");
+            copy.erase(copy.begin());
+            DSL_CHECK(copy.size() == 1 && copy.front() == "b");
+
+            dsl::list<std::string> assigned;
+            assigned = std::move(moved);
+            DSL_CHECK(assigned.size() == expected.size() && moved.empty());
+            moved.insert(moved.end(), "c");
+            DSL_CHECK(moved.size() == 1 && moved.front() == "c");
+            copy = dsl::list<std::string>();
+            DSL_CHECK(copy.empty() && copy.begin() == copy.end());
+        }
+
+        void test_list_reserve() {
+            dsl::list<int, dsl::collect_statistics> structure;
+            for (int i = 0; i < 100; i++)
+                structure.insert(structure.end(), i);
+            structure.clear();
+            DSL_CHECK(structure.statistics().spare_nodes == 0); // Nodes are freed until reserve is called
+
+            structure.reserve(50);
+            DSL_CHECK(structure.statistics().spare_nodes == 50);
+            for (int i = 0; i < 100; i++)
+                structure.insert(structure.end(), i);
+            DSL_CHECK(structure.statistics().spare_nodes == 0 && structure.statistics().reuses == 50);
+            structure.clear();
+            DSL_CHECK(structure.statistics().spare_nodes == 50); // No more than the reserved number are kept
+
+            structure.shrink_to_fit();
+            DSL_CHECK(structure.statistics().spare_nodes == 0);
+            structure.insert(structure.end(), 1);
+            structure.erase(structure.begin());
+            DSL_CHECK(structure.statistics().spare_nodes == 0 && structure.empty());
+
+            /* The spare nodes stay with the list when it is assigned, swapped or moved from */
+            structure.reserve(20);
+            dsl::list<int, dsl::collect_statistics> other;
+            other.insert(other.end(), 7);
+            structure = other;
+            DSL_CHECK(structure.size() == 1 && structure.statistics().spare_nodes == 20);
+            structure.swap(other);
+            DSL_CHECK(other.statistics().spare_nodes == 0 && structure.statistics().spare_nodes == 20);
+            dsl::list<int, dsl::collect_statistics> moved(std::move(structure));
+            DSL_CHECK(moved.size() == 1 && moved.statistics().spare_nodes == 0);
+            structure.insert(structure.end(), 3);
+            DSL_CHECK(structure.size() == 1 && structure.statistics().spare_nodes == 19);
+        }
+
+        /* Whether push accepts two values of the key type, which it must not take for a range */
+        template<class container, class = void>
+        struct pushes_two_values : std::false_type {
+        };
+
+        template<class container>
+        struct pushes_two_values<container, std::void_t<decltype(std::declval<container &>().push(1.0f, 2.0f))>>
+                : std::true_type {
+        };
+
+        void test_topk() {
+            static_assert(!pushes_two_values<dsl::topk<float>>::value, "push(first, last) must only take iterators");
+
+            for (uint64_t seed = 1; seed <= 20; seed++) {
+                xorshift generator(seed);
+                std::vector<float> scores(static_cast<size_t>(generator.below(5000)));
+                for (float &score : scores)
+                    score = static_cast<float>(generator.below(1000)) / 7;
+
+                dsl::topk<float, std::less<float>, 37> batched, one_by_one;
+                batched.push(scores.begin(), scores.end());
+                for (float score : scores)
+                    one_by_one.push(score);
+
+                std::vector<float> expected = scores;
+                std::sort(expected.begin(), expected.end(), std::greater<float>());
+                if (expected.size() > 37)
+                    expected.resize(37);
+                DSL_CHECK(batched.sorted() == expected);
+                DSL_CHECK(one_by_one.sorted() == expected);
+            }
+        }
+
+        void test_parallel() {
+            dsl::thread_pool pool(4);
+            dsl::set<long long> structure;
+            long long expected = 0;
+            for (long long i = 0; i < 100000; i++) {
+                structure.insert(i * 7919 % 1000003);
+                expected += i * 7919 % 1000003;
+            }
+
+            auto add = [](long long a, long long b) { return a + b; };
+            DSL_CHECK(dsl::parallel_reduce(structure, 0LL, add, [](long long value) { return value; }, pool) == expected);
+
+            std::atomic<size_t> visited{0};
+            dsl::parallel_for_each(structure, [&visited](long long) { visited++; }, pool);
+            DSL_CHECK(visited == structure.size());
+
+            size_t even = 0;
+            for (long long value : structure)
+                even += value % 2 == 0;
+            DSL_CHECK(dsl::parallel_count_if(structure, [](long long value) { return value % 2 == 0; }, pool) == even);
+        }
+    }
+
+    void register_containers(registry &tests) {
+        tests.push_back({"containers/dsl::hashmap/differential", test_hashmap});
+        tests.push_back({"containers/dsl::heap/differential", test_heap});
+        tests.push_back({"containers/dsl::list/differential", test_list});
+        tests.push_back({"containers/dsl::list/reserve", test_list_reserve});
+        tests.push_back({"containers/dsl::topk/differential", test_topk});
+        tests.push_back({"containers/dsl::parallel/reduce", test_parallel});
+    }
+}
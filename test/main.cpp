@@ -0,0 +1,43 @@
+//
+// Created by gvisan on 18.10.2026.
+//
+
+#include<cstdio> //for printf
+#include<cstring> //for strcmp
+#include<exception>
+#include<string>
+#include"test.h"
+
+int main(int argc, char **argv) {
+    std::string filter;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else {
+            std::fprintf(stderr, "usage: %s [--filter text]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    dsl_test::registry tests;
+    dsl_test::register_sets(tests);
+    dsl_test::register_concurrent(tests);
+    dsl_test::register_containers(tests);
+
+    size_t ran = 0, failed = 0;
+    for (const dsl_test::test_case &test : tests) {
+        if (test.name.find(filter) == std::string::npos)
+            continue;
+
+        ran++;
+        try {
+            test.run();
+            std::printf("ok     %s\n", test.name.c_str());
+        } catch (const std::exception &error) {
+            failed++;
+            std::printf("FAILED %s\n  %s\n", test.name.c_str(), error.what());
+        }
+    }
+    std::printf("%zu tests, %zu failed\n", ran, failed);
+    return failed == 0 && ran > 0 ? 0 : 1;
+}
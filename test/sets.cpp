@@ -0,0 +1,697 @@
+//
+// Created by gvisan on 18.10.2026.
+//
+
+#include<algorithm> //for set_union, set_intersection, set_difference
+#include<atomic>
+#include<iterator> //for inserter, istream_iterator
+#include<set>
+#include<sstream> //for istringstream, ostringstream
+#include<stdexcept> //for runtime_error
+#include<string>
+#include<thread>
+#include<type_traits> //for is_copy_constructible, is_constructible
+#include<utility> //for move
+#include<vector>
+#include<dsl/btree_set.h>
+#include<dsl/compact_set.h>
+#include<dsl/concurrent_set.h>
+#include<dsl/flat_set.h>
+#include<dsl/frozen_set.h>
+#include<dsl/persistent_set.h>
+#include<dsl/set.h>
+#include"test.h"
+
+namespace dsl_test {
+    namespace {
+
+        using key = int;
+
+        /* Checks that the set holds exactly the expected keys, walking it forwards and backwards */
+        template<class container>
+        void check_same(container &structure, const std::set<key> &expected) {
+            DSL_CHECK(structure.size() == expected.size());
+            DSL_CHECK(structure.empty() == expected.empty());
+            DSL_CHECK(std::vector<key>(structure.begin(), structure.end()) ==
+                      std::vector<key>(expected.begin(), expected.end()));
+
+            std::vector<key> backwards;
+            for (auto it = structure.end(); it != structure.begin();)
+                backwards.push_back(*--it);
+            DSL_CHECK(std::vector<key>(backwards.rbegin(), backwards.rend()) ==
+                      std::vector<key>(expected.begin(), expected.end()));
+        }
+
+        /* Checks that the iterator points at the same key as the std::set iterator, or that both are end iterators */
+        template<class container, class iterator>
+        void check_position(container &structure, iterator position, const std::set<key> &expected,
+                            std::set<key>::const_iterator expected_position) {
+            DSL_CHECK((position == structure.end()) == (expected_position == expected.end()));
+            if (expected_position != expected.end())
+                DSL_CHECK(*position == *expected_position);
+        }
+
+        /* Runs random inserts, erases and searches on the set and on a std::set, and compares them after every step */
+        template<class container>
+        void differential(uint64_t seed, size_t operations, int keys) {
+            xorshift generator(seed);
+            container structure;
+            std::set<key> expected;
+
+            for (size_t i = 0; i < operations; i++) {
+                key value = generator.below(keys);
+                switch (generator.below(5)) {
+                    case 0:
+                    case 1:
+                        structure.insert(value);
+                        expected.insert(value);
+                        break;
+                    case 2: {
+                        auto position = structure.find(value);
+                        check_position(structure, position, expected, expected.find(value));
+                        if (position != structure.end()) {
+                            structure.erase(position);
+                            expected.erase(value);
+                        }
+                        break;
+                    }
+                    case 3:
+                        check_position(structure, structure.lower_bound(value), expected, expected.lower_bound(value));
+                        break;
+                    default:
+                        check_position(structure, structure.upper_bound(value), expected, expected.upper_bound(value));
+                        break;
+                }
+                DSL_CHECK(structure.size() == expected.size());
+                if (i % 997 == 0)
+                    check_same(structure, expected);
+            }
+            check_same(structure, expected);
+
+            if constexpr (std::is_copy_constructible<container>::value) {
+                container copy(structure);
+                check_same(copy, expected);
+                container assigned;
+                assigned = copy;
+                check_same(assigned, expected);
+
+                structure.clear();
+                check_same(copy, expected);
+            } else {
+                structure.clear();
+            }
+            check_same(structure, std::set<key>());
+            structure.insert(7);
+            check_same(structure, std::set<key>{7});
+        }
+
+        /* Small sets with many repeated keys, and a large set. The keys of a flat_set are moved on every insert,
+         * so its large set is smaller */
+        template<class container>
+        void add_differential(registry &tests, const std::string &name, int large_keys = 50000) {
+            tests.push_back({"sets/" + name + "/small", [] {
+                for (uint64_t seed = 1; seed <= 20; seed++)
+                    differential<container>(seed, 2000, 64);
+            }});
+            tests.push_back({"sets/" + name + "/large", [large_keys] {
+                differential<container>(7, 4 * static_cast<size_t>(large_keys), large_keys);
+            }});
+        }
+
+        /* Adds the keys to the set and to the expected keys */
+        template<class container>
+        void fill(container &structure, std::set<key> &expected, xorshift &generator, size_t n, int keys) {
+            for (size_t i = 0; i < n; i++) {
+                key value = generator.below(keys);
+                structure.insert(value);
+                expected.insert(value);
+            }
+        }
+
+        /* Erasing the end iterator does nothing, and moving takes the elements without throwing */
+        template<class container>
+        void move_and_erase_end() {
+            static_assert(std::is_nothrow_move_constructible<container>::value, "the move constructor must be noexcept");
+            static_assert(std::is_nothrow_move_assignable<container>::value, "the move assignment must be noexcept");
+
+            xorshift generator(11);
+            container structure;
+            std::set<key> expected;
+            structure.erase(structure.end());
+            check_same(structure, expected);
+
+            fill(structure, expected, generator, 1000, 5000);
+            structure.erase(structure.end());
+            check_same(structure, expected);
+
+            container moved(std::move(structure));
+            check_same(moved, expected);
+            container assigned;
+            assigned = std::move(moved);
+            check_same(assigned, expected);
+
+            /* A moved-from set is empty and can be used again */
+            DSL_CHECK(structure.size() == 0 && structure.empty() && structure.begin() == structure.end());
+            DSL_CHECK(moved.size() == 0 && moved.empty() && moved.find(3) == moved.end());
+            structure.erase(structure.end());
+            structure.insert(3);
+            check_same(structure, std::set<key>{3});
+            moved.insert(4);
+            moved.insert(2);
+            check_same(moved, std::set<key>{2, 4});
+            structure = container();
+            check_same(structure, std::set<key>{});
+        }
+
+        /* Sets built one after the other in the same place draw different priorities, so they get different shapes */
+        void test_fresh_seeds() {
+            std::vector<std::vector<size_t>> shapes;
+            for (int i = 0; i < 4; i++) {
+                dsl::set<key> structure;
+                for (key value = 0; value < 2000; value++)
+                    structure.insert(value);
+                shapes.push_back(structure.statistics().depths);
+            }
+            DSL_CHECK(shapes[0] != shapes[1] || shapes[1] != shapes[2] || shapes[2] != shapes[3]);
+        }
+
+        void test_swap_statistics() {
+            dsl::set<key, std::less<key>, dsl::no_augmentation, dsl::collect_statistics> a, b;
+            for (key value = 0; value < 100; value++)
+                a.insert(value);
+            b.insert(1);
+            a.shrink_to_fit();
+            DSL_CHECK(a.statistics().inserts == 100);
+
+            a.swap(b);
+            DSL_CHECK(a.size() == 1 && a.statistics().inserts == 1);
+            DSL_CHECK(b.size() == 100 && b.statistics().inserts == 100);
+
+            /* The swapped sets keep drawing valid priorities */
+            for (key value = 100; value < 1000; value++)
+                b.insert(value);
+            std::set<key> expected;
+            for (key value = 0; value < 1000; value++)
+                expected.insert(value);
+            check_same(b, expected);
+        }
+
+        /* Runs a union, an intersection or a difference, chosen by the seed, on two sets filled with smallest to
+         * largest random keys */
+        void check_algebra(uint64_t seed, int smallest, int largest, int keys) {
+            xorshift generator(seed);
+            size_t sizes[2] = {static_cast<size_t>(smallest + generator.below(largest - smallest)),
+                               static_cast<size_t>(smallest + generator.below(largest - smallest))};
+            dsl::set<key> a, b;
+            std::set<key> expected_a, expected_b;
+            fill(a, expected_a, generator, sizes[0], keys);
+            fill(b, expected_b, generator, sizes[1], keys);
+
+            std::set<key> expected;
+            dsl::set<key> result(a), other(b);
+            switch (seed % 3) {
+                case 0:
+                    result.set_union(other);
+                    std::set_union(expected_a.begin(), expected_a.end(), expected_b.begin(), expected_b.end(),
+                                   std::inserter(expected, expected.end()));
+                    break;
+                case 1:
+                    result.set_intersection(other);
+                    std::set_intersection(expected_a.begin(), expected_a.end(), expected_b.begin(),
+                                          expected_b.end(), std::inserter(expected, expected.end()));
+                    break;
+                default:
+                    result.set_difference(other);
+                    std::set_difference(expected_a.begin(), expected_a.end(), expected_b.begin(), expected_b.end(),
+                                        std::inserter(expected, expected.end()));
+                    break;
+            }
+            check_same(result, expected);
+            check_same(other, std::set<key>());
+            check_same(a, expected_a);
+
+            /* The nodes moved between the sets must still be usable */
+            result.insert(-1);
+            expected.insert(-1);
+            check_same(result, expected);
+        }
+
+        void test_algebra() {
+            for (uint64_t seed = 1; seed <= 30; seed++)
+                check_algebra(seed, 0, 3000, 4000);
+        }
+
+        /* Forces the set algebra to fork while it exists, so that the parallel code runs on single-core machines too */
+        struct forced_fork_depth {
+            explicit forced_fork_depth(int depth) {
+                dsl::detail::set_algebra_fork_depth = depth;
+            }
+
+            ~forced_fork_depth() {
+                dsl::detail::set_algebra_fork_depth = -1;
+            }
+        };
+
+        void test_parallel_algebra() {
+            /* Above the size from which the algebra forks by itself when there are several cores */
+            for (uint64_t seed = 1; seed <= 3; seed++)
+                check_algebra(seed, 100000, 150000, 1000000);
+
+            forced_fork_depth forced(3);
+            for (uint64_t seed = 1; seed <= 30; seed++)
+                check_algebra(seed, 0, 3000, 4000);
+            for (uint64_t seed = 1; seed <= 3; seed++)
+                check_algebra(seed, 100000, 150000, 1000000);
+        }
+
+        void test_split_join() {
+            for (uint64_t seed = 1; seed <= 30; seed++) {
+                xorshift generator(seed);
+                dsl::set<key> structure;
+                std::set<key> expected;
+                fill(structure, expected, generator, generator.below(5000), 10000);
+
+                key border = generator.below(10000);
+                dsl::set<key> after = structure.split(border);
+                check_same(structure, std::set<key>(expected.begin(), expected.lower_bound(border)));
+                check_same(after, std::set<key>(expected.lower_bound(border), expected.end()));
+
+                structure.join(after);
+                check_same(structure, expected);
+                check_same(after, std::set<key>());
+
+                key low = generator.below(10000), high = generator.below(10000);
+                if (high < low)
+                    std::swap(low, high);
+                structure.erase_range(structure.lower_bound(low), structure.lower_bound(high));
+                expected.erase(expected.lower_bound(low), expected.lower_bound(high));
+                check_same(structure, expected);
+            }
+        }
+
+        void test_sorted_build() {
+            static_assert(!std::is_constructible<dsl::set<long>, int, int>::value, "the range constructor only takes iterators");
+            for (uint64_t seed = 1; seed <= 20; seed++) {
+                xorshift generator(seed);
+                std::set<key> expected;
+                for (int i = generator.below(5000); i > 0; i--)
+                    expected.insert(generator.below(20000));
+                std::vector<key> sorted(expected.begin(), expected.end());
+
+                dsl::set<key> built(sorted.begin(), sorted.end());
+                check_same(built, expected);
+
+                dsl::set<key> merged;
+                std::set<key> expected_merged;
+                fill(merged, expected_merged, generator, 1000, 20000);
+                merged.insert_sorted_range(sorted.begin(), sorted.end());
+                expected_merged.insert(sorted.begin(), sorted.end());
+                check_same(merged, expected_merged);
+
+                /* Input iterators can only be read once */
+                std::string text;
+                for (key value : sorted)
+                    text += std::to_string(value) + " ";
+                std::istringstream input(text), more(text);
+                dsl::set<key> read((std::istream_iterator<key>(input)), std::istream_iterator<key>());
+                check_same(read, expected);
+                merged.insert_sorted_range(std::istream_iterator<key>(more), std::istream_iterator<key>());
+                check_same(merged, expected_merged);
+            }
+        }
+
+        using ordered_set = dsl::set<key, std::less<key>, dsl::order_statistics>;
+
+        /* Checks nth, rank, count_range and distance against the positions in the expected keys */
+        void check_order(ordered_set &structure, const std::set<key> &expected, xorshift &generator, int keys) {
+            std::vector<key> sorted(expected.begin(), expected.end());
+            for (size_t i = 0; i < sorted.size(); i += 7)
+                DSL_CHECK(*structure.nth(i) == sorted[i]);
+            DSL_CHECK(structure.nth(sorted.size()) == structure.end());
+
+            for (int i = 0; i < 200; i++) {
+                key low = generator.below(keys), high = generator.below(keys);
+                size_t before = std::distance(expected.begin(), expected.lower_bound(low));
+                DSL_CHECK(structure.rank(low) == before);
+                size_t between = low < high ? std::distance(expected.lower_bound(low), expected.lower_bound(high)) : 0;
+                DSL_CHECK(structure.count_range(low, high) == between);
+                if (low < high)
+                    DSL_CHECK(structure.distance(structure.lower_bound(low), structure.lower_bound(high)) == between);
+            }
+            DSL_CHECK(structure.distance(structure.begin(), structure.end()) == expected.size());
+        }
+
+        /* The subtree sizes must stay right after every operation that moves or destroys nodes */
+        void test_order_statistics() {
+            xorshift generator(3);
+            ordered_set structure;
+            std::set<key> expected;
+            fill(structure, expected, generator, 5000, 20000);
+            check_order(structure, expected, generator, 20000);
+
+            for (int round = 0; round < 20; round++) {
+                for (int i = 0; i < 200; i++) {
+                    auto position = structure.find(generator.below(20000));
+                    if (position != structure.end()) {
+                        expected.erase(*position);
+                        structure.erase(position);
+                    }
+                }
+                check_order(structure, expected, generator, 20000);
+
+                key low = generator.below(20000), high = low + generator.below(500);
+                structure.erase_range(structure.lower_bound(low), structure.lower_bound(high));
+                expected.erase(expected.lower_bound(low), expected.lower_bound(high));
+                check_order(structure, expected, generator, 20000);
+
+                key border = generator.below(20000);
+                ordered_set after = structure.split(border);
+                std::set<key> expected_after(expected.lower_bound(border), expected.end());
+                expected.erase(expected.lower_bound(border), expected.end());
+                check_order(structure, expected, generator, 20000);
+                check_order(after, expected_after, generator, 20000);
+
+                structure.join(after);
+                expected.insert(expected_after.begin(), expected_after.end());
+                check_order(structure, expected, generator, 20000);
+
+                fill(structure, expected, generator, 300, 20000);
+            }
+        }
+
+        /* The sum of the keys, for the augmented policy */
+        struct sum {
+            using value_type = long long;
+
+            static value_type identity() { return 0; }
+
+            static value_type lift(key value) { return value; }
+
+            static value_type combine(value_type a, value_type b) { return a + b; }
+        };
+
+        void test_aggregate() {
+            xorshift generator(4);
+            dsl::set<key, std::less<key>, dsl::augmented<sum>> structure;
+            std::set<key> expected;
+            fill(structure, expected, generator, 5000, 20000);
+
+            for (int i = 0; i < 1000; i++) {
+                key low = generator.below(20000), high = generator.below(20000);
+                long long total = 0;
+                for (auto it = expected.lower_bound(low); it != expected.end() && *it < high; it++)
+                    total += *it;
+                DSL_CHECK(structure.aggregate(low, high) == total);
+
+                auto position = structure.find(generator.below(20000));
+                if (position != structure.end()) {
+                    expected.erase(*position);
+                    structure.erase(position);
+                }
+            }
+
+            long long total = 0;
+            for (key value : expected)
+                total += value;
+            DSL_CHECK(structure.aggregate() == total);
+        }
+
+        void test_find_many() {
+            xorshift generator(5);
+            dsl::set<key> structure;
+            std::set<key> expected;
+            fill(structure, expected, generator, 5000, 20000);
+
+            std::multiset<key> probes;
+            for (int i = 0; i < 3000; i++)
+                probes.insert(generator.below(21000));
+            std::vector<key> sorted(probes.begin(), probes.end());
+
+            std::vector<dsl::set<key>::iterator> found(sorted.size(), structure.end()), bounds = found;
+            structure.find_many(sorted.begin(), sorted.end(), found.begin());
+            structure.lower_bound_many(sorted.begin(), sorted.end(), bounds.begin());
+            for (size_t i = 0; i < sorted.size(); i++) {
+                check_position(structure, found[i], expected, expected.find(sorted[i]));
+                check_position(structure, bounds[i], expected, expected.lower_bound(sorted[i]));
+            }
+        }
+
+        void test_frozen() {
+            for (uint64_t seed = 1; seed <= 20; seed++) {
+                xorshift generator(seed);
+                dsl::set<key> source;
+                std::set<key> expected;
+                fill(source, expected, generator, generator.below(3000), 6000);
+
+                std::multiset<key> with_duplicates(expected.begin(), expected.end());
+                with_duplicates.insert(expected.begin(), expected.end());
+                dsl::frozen_set<key> from_range(with_duplicates.begin(), with_duplicates.end());
+                dsl::frozen_set<key> from_set(source);
+
+                /* Input iterators are read once */
+                std::ostringstream text;
+                for (key value : with_duplicates)
+                    text << value << ' ';
+                std::istringstream input(text.str());
+                dsl::frozen_set<key> from_input((std::istream_iterator<key>(input)), std::istream_iterator<key>());
+
+                for (dsl::frozen_set<key> *structure : {&from_range, &from_set, &from_input}) {
+                    check_same(*structure, expected);
+                    for (key value = -1; value <= 6001; value += 3) {
+                        check_position(*structure, structure->find(value), expected, expected.find(value));
+                        check_position(*structure, structure->lower_bound(value), expected,
+                                       expected.lower_bound(value));
+                        check_position(*structure, structure->upper_bound(value), expected,
+                                       expected.upper_bound(value));
+                    }
+                }
+            }
+        }
+
+        void test_persistent_versions() {
+            xorshift generator(6);
+            dsl::persistent_set<key> structure;
+            std::set<key> expected;
+            std::vector<std::pair<dsl::persistent_set<key>, std::set<key>>> versions;
+
+            for (int i = 0; i < 5000; i++) {
+                key value = generator.below(1000);
+                if (generator.below(3) == 0) {
+                    auto position = structure.find(value);
+                    if (position != structure.end()) {
+                        structure.erase(position);
+                        expected.erase(value);
+                    }
+                } else {
+                    structure.insert(value);
+                    expected.insert(value);
+                }
+                if (i % 250 == 0)
+                    versions.emplace_back(structure.snapshot(), expected);
+            }
+
+            /* The snapshots kept the keys they had when they were taken */
+            for (auto &version : versions)
+                check_same(version.first, version.second);
+            check_same(structure, expected);
+        }
+
+        /* Readers take snapshots while one writer modifies the set. Every snapshot must be a sorted set of the
+         * size it reports. Build with -fsanitize=thread to check the publication of the versions */
+        void test_persistent_concurrent_snapshots() {
+            dsl::persistent_set<key> structure;
+            std::atomic<bool> done(false), valid(true);
+            std::vector<std::thread> readers;
+            for (int r = 0; r < 3; r++) {
+                readers.emplace_back([&] {
+                    while (!done) {
+                        dsl::persistent_set<key> version = structure.snapshot();
+                        size_t seen = 0;
+                        key previous = -1;
+                        for (key value : version) {
+                            if (value <= previous)
+                                valid = false;
+                            previous = value;
+                            seen++;
+                        }
+                        if (seen != version.size())
+                            valid = false;
+                    }
+                });
+            }
+
+            xorshift generator(12);
+            for (int i = 0; i < 50000; i++) {
+                key value = generator.below(2000);
+                if (i % 3 == 2)
+                    structure.erase(structure.find(value)); // Erasing end() when the key is missing does nothing
+                else
+                    structure.insert(value);
+            }
+            done = true;
+            for (std::thread &reader : readers)
+                reader.join();
+            DSL_CHECK(valid);
+        }
+
+        /* A reader paused inside the critical section that snapshot() runs in, after it loaded a version, must not
+         * hold back the writer. The writer keeps publishing and the paused reader keeps its version */
+        void test_persistent_stalled_reader() {
+            dsl::persistent_set<key> structure;
+            for (key value = 0; value < 100; value++)
+                structure.insert(value);
+
+            std::atomic<bool> inside(false), resume(false), kept(false);
+            std::thread reader([&] {
+                dsl::detail::epoch_guard paused;
+                dsl::persistent_set<key> version = structure.snapshot();
+                inside = true;
+                while (!resume)
+                    std::this_thread::yield();
+                size_t seen = 0;
+                for (key value : version)
+                    seen += value == static_cast<key>(seen);
+                kept = seen == 100 && version.size() == 100;
+            });
+            while (!inside)
+                std::this_thread::yield();
+
+            xorshift generator(13);
+            std::set<key> expected;
+            for (key value = 0; value < 100; value++)
+                expected.insert(value);
+            for (int i = 0; i < 20000; i++) {
+                key value = generator.below(1000);
+                if (i % 2 == 1) {
+                    structure.erase(structure.find(value));
+                    expected.erase(value);
+                } else {
+                    structure.insert(value);
+                    expected.insert(value);
+                }
+            }
+            check_same(structure, expected); // Done while the reader is still paused
+
+            resume = true;
+            reader.join();
+            DSL_CHECK(kept);
+        }
+
+        void test_flat_set_growth() {
+            /* Crosses the inline capacity, so the keys move to the heap */
+            dsl::flat_set<key, std::less<key>, 4> structure;
+            std::set<key> expected;
+            xorshift generator(8);
+            fill(structure, expected, generator, 100, 1000);
+            check_same(structure, expected);
+
+            dsl::flat_set<key, std::less<key>, 4> copy(structure);
+            structure.clear();
+            check_same(copy, expected);
+            check_same(structure, std::set<key>());
+
+            /* Moving inline keys moves them one by one and leaves the source empty */
+            structure.insert(5);
+            structure.insert(2);
+            dsl::flat_set<key, std::less<key>, 4> moved(std::move(structure));
+            check_same(moved, std::set<key>{2, 5});
+            check_same(structure, std::set<key>());
+            copy = std::move(moved);
+            check_same(copy, std::set<key>{2, 5});
+        }
+
+        /* A key that counts the live keys, and whose copy throws once a given number of copies were made */
+        struct fragile_key {
+            static int live, copies_left;
+            int value;
+
+            fragile_key(int v) : value(v) {
+                live++;
+            }
+
+            fragile_key(const fragile_key &other) : value(other.value) {
+                if (copies_left-- == 0)
+                    throw std::runtime_error("copy failed");
+                live++;
+            }
+
+            fragile_key &operator=(const fragile_key &) = default;
+
+            ~fragile_key() {
+                live--;
+            }
+
+            friend bool operator<(const fragile_key &a, const fragile_key &b) { return a.value < b.value; }
+        };
+
+        int fragile_key::live = 0, fragile_key::copies_left = -1;
+
+        /* A copy that fails part of the way destroys the keys it already copied, inline or on the heap */
+        void test_flat_set_failed_copy() {
+            for (int size : {3, 100}) {
+                {
+                    dsl::flat_set<fragile_key, std::less<fragile_key>, 4> structure;
+                    for (int value = 0; value < size; value++)
+                        structure.insert(fragile_key(value));
+                    int before = fragile_key::live;
+
+                    fragile_key::copies_left = size / 2;
+                    bool thrown = false;
+                    try {
+                        dsl::flat_set<fragile_key, std::less<fragile_key>, 4> copy(structure);
+                    } catch (const std::runtime_error &) {
+                        thrown = true;
+                    }
+                    fragile_key::copies_left = -1;
+                    DSL_CHECK(thrown && fragile_key::live == before);
+                    DSL_CHECK(structure.size() == static_cast<size_t>(size));
+                }
+                DSL_CHECK(fragile_key::live == 0);
+            }
+        }
+
+        void test_string_keys() {
+            xorshift generator(9);
+            dsl::set<std::string> structure;
+            std::set<std::string> expected;
+            for (int i = 0; i < 3000; i++) {
+                std::string value = "key-" + std::to_string(generator.below(2000)) + "-with-a-long-suffix";
+                structure.insert(value);
+                expected.insert(value);
+            }
+            DSL_CHECK(std::vector<std::string>(structure.begin(), structure.end()) ==
+                      std::vector<std::string>(expected.begin(), expected.end()));
+        }
+    }
+
+    void register_sets(registry &tests) {
+        add_differential<dsl::set<key>>(tests, "dsl::set");
+        add_differential<dsl::set<key, std::less<key>, dsl::order_statistics>>(tests, "dsl::set+order_statistics");
+        add_differential<dsl::btree_set<key>>(tests, "dsl::btree_set");
+        add_differential<dsl::compact_set<key>>(tests, "dsl::compact_set");
+        add_differential<dsl::flat_set<key>>(tests, "dsl::flat_set", 5000);
+        add_differential<dsl::persistent_set<key>>(tests, "dsl::persistent_set");
+        add_differential<dsl::concurrent_set<key>>(tests, "dsl::concurrent_set");
+
+        tests.push_back({"sets/dsl::set/move_and_erase_end", move_and_erase_end<dsl::set<key>>});
+        tests.push_back({"sets/dsl::btree_set/move_and_erase_end", move_and_erase_end<dsl::btree_set<key>>});
+        tests.push_back({"sets/dsl::compact_set/move_and_erase_end", move_and_erase_end<dsl::compact_set<key>>});
+        tests.push_back({"sets/dsl::flat_set/move_and_erase_end", move_and_erase_end<dsl::flat_set<key>>});
+        tests.push_back({"sets/dsl::set/fresh_seeds", test_fresh_seeds});
+        tests.push_back({"sets/dsl::set/swap_statistics", test_swap_statistics});
+        tests.push_back({"sets/dsl::set/algebra", test_algebra});
+        tests.push_back({"sets/dsl::set/parallel_algebra", test_parallel_algebra});
+        tests.push_back({"sets/dsl::set/split_join", test_split_join});
+        tests.push_back({"sets/dsl::set/sorted_build", test_sorted_build});
+        tests.push_back({"sets/dsl::set/order_statistics", test_order_statistics});
+        tests.push_back({"sets/dsl::set/aggregate", test_aggregate});
+        tests.push_back({"sets/dsl::set/find_many", test_find_many});
+        tests.push_back({"sets/dsl::set/string_keys", test_string_keys});
+        tests.push_back({"sets/dsl::frozen_set/search", test_frozen});
+        tests.push_back({"sets/dsl::persistent_set/versions", test_persistent_versions});
+        tests.push_back({"sets/dsl::persistent_set/concurrent_snapshots", test_persistent_concurrent_snapshots});
+        tests.push_back({"sets/dsl::persistent_set/stalled_reader", test_persistent_stalled_reader});
+        tests.push_back({"sets/dsl::flat_set/growth", test_flat_set_growth});
+        tests.push_back({"sets/dsl::flat_set/failed_copy", test_flat_set_failed_copy});
+    }
+}
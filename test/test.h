@@ -0,0 +1,68 @@
+//
+// Created by gvisan on 18.10.2026.
+//
+
+#ifndef DSL_TEST_H
+#define DSL_TEST_H
+
+#include<cstdint> //for uint64_t
+#include<functional> //for function
+#include<stdexcept> //for runtime_error
+#include<string>
+#include<vector>
+
+namespace dsl_test {
+
+    /* A test case, run by dsl_test */
+    struct test_case {
+        std::string name;
+        std::function<void()> run;
+    };
+
+    using registry = std::vector<test_case>;
+
+    /* Add the differential tests of the ordered sets against std::set */
+    void register_sets(registry &tests);
+
+    /* Add the multi-threaded stress tests of concurrent_set */
+    void register_concurrent(registry &tests);
+
+    /* Add the differential tests of hashmap, heap, list and topk against their std counterparts */
+    void register_containers(registry &tests);
+
+    /* Thrown by check when a condition does not hold */
+    struct failure : std::runtime_error {
+        using std::runtime_error::runtime_error;
+    };
+
+    inline void check(bool condition, const char *text, const char *file, int line) {
+        if (!condition)
+            throw failure(std::string(file) + ":" + std::to_string(line) + ": check failed: " + text);
+    }
+
+    /* A small xorshift64* generator, so that every run tests the same operations */
+    struct xorshift {
+        uint64_t state;
+
+        explicit xorshift(uint64_t seed) : state(seed * 0x9E3779B97F4A7C15ULL | 1u) {
+
+        }
+
+        uint64_t next() {
+            state ^= state >> 12u;
+            state ^= state << 25u;
+            state ^= state >> 27u;
+            return state * 0x2545F4914F6CDD1DULL;
+        }
+
+        /* Returns a number in [0, bound) */
+        int below(int bound) {
+            return static_cast<int>(next() % static_cast<uint64_t>(bound));
+        }
+    };
+}
+
+/* Checks the condition, the tests are built without assert since the default build type defines NDEBUG */
+#define DSL_CHECK(condition) dsl_test::check(static_cast<bool>(condition), #condition, __FILE__, __LINE__)
+
+#endif //DSL_TEST_H